@@ -0,0 +1,172 @@
+#include "assetpack.h"
+#include "config.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QBuffer>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QWebEngineProfile>
+#include <QWebEngineUrlRequestInfo>
+#include <QWebEngineUrlSchemeHandler>
+#include <QWebEngineUrlRequestJob>
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+#include <QWebEngineUrlScheme>
+#endif
+
+const char *const AssetPack::SCHEME = "zdfpack";
+static const char *const PACK_HOST = "pack";
+
+// --------------------------- AssetPack ---------------------------
+void AssetPack::registerScheme() {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    QWebEngineUrlScheme scheme(SCHEME);
+    scheme.setSyntax(QWebEngineUrlScheme::Syntax::Host);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    // 改写后的样式表引用的字体按跨源方式请求，须允许 CORS 才能从资源包加载
+    scheme.setFlags(QWebEngineUrlScheme::SecureScheme | QWebEngineUrlScheme::CorsEnabled);
+#else
+    scheme.setFlags(QWebEngineUrlScheme::SecureScheme);
+#endif
+    QWebEngineUrlScheme::registerScheme(scheme);
+#endif
+}
+
+bool AssetPack::open(const QString &path) {
+    QElapsedTimer timer;
+    timer.start();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        ZDF_LOG_EVENT(CatStartup, L_WARNING, "资源包无法打开：%1（%2）", path, m_file.errorString());
+        return false;
+    }
+    const uchar *base = m_file.map(0, m_file.size());
+    const char *error = nullptr;
+    if (!base || !m_reader.open(base, quint64(m_file.size()), &error)) {
+        ZDF_LOG_EVENT(CatStartup, L_WARNING, "资源包无法使用：%1（%2）", path, base ? error : "无法映射文件");
+        m_file.close();
+        return false;
+    }
+    m_baseUrl = QUrl(QString::fromUtf8(m_reader.baseUrl()));
+    ZDF_LOG_EVENT(CatStartup, L_INFO, "资源包：%1，%2 个文件，%3 MB，映射耗时 %4 ms", path, m_reader.count(),
+                  double(m_file.size()) / (1024 * 1024), double(timer.nsecsElapsed()) / 1e6);
+    ZDF_LOG_EVENT(CatStartup, L_INFO, "资源包基准地址：%1，打包时间：%2", m_baseUrl.toString(),
+                  QDateTime::fromMSecsSinceEpoch(m_reader.header().createdMs).toString("yyyy-MM-dd hh:mm:ss"));
+    return true;
+}
+
+// 资源包不保存查询参数，无法判断 app.js?v=… 是否就是打包时的版本：带查询参数的请求一律视为不在资源包中
+bool AssetPack::pathFor(const QUrl &url, QByteArray &path) const {
+    if (url.scheme() != m_baseUrl.scheme() || url.host() != m_baseUrl.host() ||
+        url.port(-1) != m_baseUrl.port(-1) || url.hasQuery()) return false;
+    const QString basePath = m_baseUrl.path(QUrl::FullyDecoded);
+    const QString urlPath = url.path(QUrl::FullyDecoded);
+    if (!urlPath.startsWith(basePath) || urlPath.size() == basePath.size()) return false;
+    path = urlPath.mid(basePath.size()).toUtf8();
+    return true;
+}
+
+// zdfpack://pack/<服务器上的完整路径> 与网络地址一一对应：改写后的脚本和样式表中的相对引用
+// （CSS 的 url(../img/x.png)、webpack 按脚本地址加载的分块）仍落在 zdfpack: 下，由协议处理器决定本地应答或回到网络
+QUrl AssetPack::packUrl(const QUrl &url) {
+    QUrl target(url);
+    target.setScheme(SCHEME);
+    target.setHost(PACK_HOST);
+    target.setPort(-1);
+    return target;
+}
+
+QUrl AssetPack::networkUrl(const QUrl &packUrl) const {
+    QUrl target(packUrl);
+    target.setScheme(m_baseUrl.scheme());
+    target.setHost(m_baseUrl.host());
+    target.setPort(m_baseUrl.port(-1));
+    return target;
+}
+
+void AssetPack::logStats(LogCategory category, const char *title) const {
+    ZDF_LOG_EVENT(category, L_INFO, "%1：命中 %2，未命中 %3，本地提供 %4 KB", title,
+                  hits.load(), misses.load(), servedBytes.load() / 1024);
+    if (const quint64 skipped = bypassed.load())
+        ZDF_LOG_EVENT(category, L_INFO, "%1：另有 %2 个带查询参数的请求未查找资源包，直接访问网络", title, skipped);
+}
+
+// --------------------------- 请求改写与应答 ---------------------------
+// 只改写脚本、样式、图片和音视频：改写后资源来自 zdfpack: 源，需要跨源许可的请求
+// （XHR/fetch、字体）不改写，避免被同源策略拦截。Qt 5.14 以下协议不能声明 CORS，
+// 样式表也不改写，否则其中引用的字体会变成对 zdfpack: 的跨源请求而被拦截
+static bool redirectable(QWebEngineUrlRequestInfo::ResourceType type) {
+    switch (type) {
+    case QWebEngineUrlRequestInfo::ResourceTypeScript:
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    case QWebEngineUrlRequestInfo::ResourceTypeStylesheet:
+#endif
+    case QWebEngineUrlRequestInfo::ResourceTypeImage:
+    case QWebEngineUrlRequestInfo::ResourceTypeMedia:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool AssetPack::redirect(QWebEngineUrlRequestInfo &info) {
+    if (!isOpen() || info.requestMethod() != "GET" || !redirectable(info.resourceType())) return false;
+    QByteArray path;
+    if (!pathFor(info.requestUrl(), path)) {
+        // 基准地址下带查询参数的请求单独计数，不然命中率会高估资源包的作用
+        if (info.requestUrl().hasQuery() && pathFor(info.requestUrl().adjusted(QUrl::RemoveQuery), path)) ++bypassed;
+        return false;
+    }
+    zdfpack::Reader::Entry entry;
+    if (!find(path, entry)) {
+        ++misses;
+        return false;
+    }
+    info.redirect(packUrl(info.requestUrl()));
+    return true;
+}
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+// 应答直接读取映射内存：QBuffer 引用 fromRawData 构造的 QByteArray，只读不会触发复制。
+// 相对引用解析出的地址不一定在资源包中（或带查询参数），这时重定向回对应的网络地址
+class AssetPackSchemeHandler : public QWebEngineUrlSchemeHandler {
+public:
+    explicit AssetPackSchemeHandler(QObject *parent) : QWebEngineUrlSchemeHandler(parent) {}
+
+    void requestStarted(QWebEngineUrlRequestJob *job) override {
+        AssetPack &pack = AssetPack::instance();
+        const QUrl url = pack.networkUrl(job->requestUrl());
+        QByteArray path;
+        zdfpack::Reader::Entry entry;
+        if (!pack.pathFor(url, path) || !pack.find(path, entry)) {
+            job->redirect(url);     // 重定向后的请求再经过拦截器，未命中在那里计数
+            return;
+        }
+        QBuffer *buffer = new QBuffer;
+        buffer->setData(entry.data);
+        buffer->open(QIODevice::ReadOnly);
+        QObject::connect(job, &QObject::destroyed, buffer, &QObject::deleteLater);
+        job->reply(QByteArray(entry.mime.constData(), entry.mime.size()), buffer);
+        ++pack.hits;
+        pack.servedBytes += quint64(entry.data.size());
+    }
+};
+#endif
+
+void installAssetPack(QWebEngineProfile *profile, const AppConfig &config) {
+    if (config.assetPack.path.isEmpty()) return;
+#if QT_VERSION < QT_VERSION_CHECK(5, 12, 0)
+    Q_UNUSED(profile);
+    ZDF_LOG_EVENT(CatStartup, L_WARNING, "资源包需要 Qt 5.12 及以上版本（当前 %1），已忽略", qVersion());
+#else
+    const QString path = QDir::isAbsolutePath(config.assetPack.path) ? config.assetPack.path
+                         : QCoreApplication::applicationDirPath() + "/" + config.assetPack.path;
+    AssetPack &pack = AssetPack::instance();
+    if (!pack.open(path)) return;
+
+    if (pack.baseUrl().host() != QUrl(config.url).host())
+        ZDF_LOG_EVENT(CatStartup, L_WARNING, "资源包的基准地址与考试地址 %1 不在同一服务器，可能不会命中", config.url);
+
+    profile->installUrlSchemeHandler(AssetPack::SCHEME, new AssetPackSchemeHandler(profile));
+#endif
+}
@@ -0,0 +1,68 @@
+#ifndef ZDF_ASSETPACK_H
+#define ZDF_ASSETPACK_H
+
+#include <QString>
+#include <QFile>
+#include <QUrl>
+
+#include <atomic>
+
+#include "packformat.h"
+#include "logger.h"
+
+class QWebEngineProfile;
+class QWebEngineUrlRequestInfo;
+struct AppConfig;
+
+// --------------------------- 本地资源包 ---------------------------
+// 考试开始时几十台终端同时向同一台学校服务器请求相同的 JS、图片和音频。
+// 事先分发到各终端的资源包（由 zdf-pack 生成）整体映射到内存，页面请求基准地址下的脚本、
+// 样式、图片和音频时，请求拦截器把命中资源包的请求改写为 zdfpack: 地址，由协议处理器
+// 直接以映射内存应答（不复制）；未命中的请求照常访问网络。
+// 映射在进程生命周期内保持有效；查找只读，可在任意线程调用（含 Qt 5.13 以下拦截器所在的 IO 线程）
+class AssetPack {
+public:
+    static AssetPack& instance(){ static AssetPack p; return p; }
+
+    static const char *const SCHEME;
+
+    // 协议须在 QApplication 创建前注册（Qt 5.12 起）
+    static void registerScheme();
+
+    // 映射资源包并检查索引，失败时记录原因并返回 false
+    bool open(const QString &path);
+    bool isOpen() const { return m_reader.isOpen(); }
+    int fileCount() const { return m_reader.count(); }
+    QUrl baseUrl() const { return m_baseUrl; }
+
+    // 基准地址下的请求映射为资源包内的路径，不在基准地址下或带查询参数时返回 false
+    bool pathFor(const QUrl &url, QByteArray &path) const;
+
+    // 网络地址与 zdfpack: 地址互相转换（路径和查询参数不变）
+    static QUrl packUrl(const QUrl &url);
+    QUrl networkUrl(const QUrl &packUrl) const;
+    bool find(const QByteArray &path, zdfpack::Reader::Entry &entry) const { return m_reader.find(path, entry); }
+
+    // 由请求拦截器（urlfilter.cpp）调用，Qt 5.13 起在 GUI 线程，更早的版本在 IO 线程：
+    // 命中资源包的请求改写为 zdfpack: 地址。
+    // 资源包未打开或请求不可改写时返回 false
+    bool redirect(QWebEngineUrlRequestInfo &info);
+
+    // 命中统计（任意线程）；bypassed 为基准地址下带查询参数、因而不查资源包的请求
+    std::atomic<quint64> hits{0}, misses{0}, bypassed{0}, servedBytes{0};
+    void logStats(LogCategory category, const char *title) const;
+
+private:
+    AssetPack() = default;
+    AssetPack(const AssetPack&)=delete; AssetPack& operator=(const AssetPack&)=delete;
+
+    QFile m_file;
+    zdfpack::Reader m_reader;
+    QUrl m_baseUrl;
+};
+
+// 按 config.json 的 assetPack.path 打开资源包，并在 profile 上安装协议处理器。
+// 须在首个页面创建前调用；未配置或打开失败时不做任何改动
+void installAssetPack(QWebEngineProfile *profile, const AppConfig &config);
+
+#endif // ZDF_ASSETPACK_H
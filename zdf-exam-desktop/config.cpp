@@ -0,0 +1,552 @@
+#include "config.h"
+#include "logger.h"
+
+#include <QCoreApplication>
+#include <QStandardPaths>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QJsonDocument>
+#include <QJsonValue>
+#include <QJsonArray>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QSet>
+#include <QUrl>
+#include <QHostAddress>
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+#include <QCborValue>
+#include <QCborMap>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+// --------------------------- 字段编译 ---------------------------
+// 缺省字段静默取默认值；类型错误或超出范围时记录警告后取默认值
+static QString fieldName(const QString &path, const char *key) {
+    return path.isEmpty() ? QString::fromLatin1(key) : path + '.' + QLatin1String(key);
+}
+
+static int readInt(const QJsonObject &obj, const QString &path, const char *key,
+                   int def, int minValue, int maxValue, QStringList &warnings) {
+    const QJsonValue v = obj.value(QLatin1String(key));
+    if (v.isUndefined() || v.isNull()) return def;
+    const double d = v.toDouble();
+    if (!v.isDouble() || d != std::floor(d) || d < minValue || d > maxValue) {
+        warnings << QString("%1 应为 %2~%3 的整数，已使用默认值 %4")
+                    .arg(fieldName(path, key)).arg(minValue).arg(maxValue).arg(def);
+        return def;
+    }
+    return int(d);
+}
+
+static bool readBool(const QJsonObject &obj, const QString &path, const char *key,
+                     bool def, QStringList &warnings) {
+    const QJsonValue v = obj.value(QLatin1String(key));
+    if (v.isUndefined() || v.isNull()) return def;
+    if (!v.isBool()) {
+        warnings << QString("%1 应为 true/false，已使用默认值 %2")
+                    .arg(fieldName(path, key), def ? "true" : "false");
+        return def;
+    }
+    return v.toBool();
+}
+
+static QString readRequiredString(const QJsonObject &obj, const char *key, QStringList &errors) {
+    const QString s = obj.value(QLatin1String(key)).toString();
+    if (s.isEmpty()) errors << QString("缺少必填字段 %1").arg(QLatin1String(key));
+    return s;
+}
+
+static QJsonObject readSection(const QJsonObject &obj, const char *key, QStringList &warnings) {
+    const QJsonValue v = obj.value(QLatin1String(key));
+    if (!v.isUndefined() && !v.isNull() && !v.isObject())
+        warnings << QString("%1 应为对象，整节使用默认值").arg(QLatin1String(key));
+    return v.toObject();
+}
+
+static QStringList readStringList(const QJsonObject &obj, const QString &path, const char *key,
+                                  QStringList &warnings) {
+    QStringList list;
+    const QJsonValue v = obj.value(QLatin1String(key));
+    if (v.isUndefined() || v.isNull()) return list;
+    if (!v.isArray()) {
+        warnings << QString("%1 应为字符串数组，已忽略").arg(fieldName(path, key));
+        return list;
+    }
+    const QJsonArray array = v.toArray();
+    for (int i = 0; i < array.size(); ++i) {
+        if (array.at(i).isString()) list << array.at(i).toString();
+        else warnings << QString("%1 第 %2 项应为字符串，已忽略").arg(fieldName(path, key)).arg(i + 1);
+    }
+    return list;
+}
+
+AppConfig::AppConfig()
+    : url("http://stu.sdzdf.com/"), exitPassword("123456"), appName("zdf-exam-desktop"),
+      disableHardwareAcceleration(false) {
+    lowMemory.enabled = true;
+    lowMemory.memoryThresholdMB = 4096;
+    lowMemory.progressiveLoading = true;
+    lowMemory.progressiveLoadingDelayMs = 3000;
+#ifdef QT_DEBUG
+    log.level = L_DEBUG;
+#else
+    log.level = L_INFO;
+#endif
+    log.maxFileSizeMB = 10;
+    log.maxBackups = 5;
+    log.binaryFormat = false;
+    log.crashRingKB = 0;
+    log.startupTrace = false;
+    keystroke.summaryMinutes = 5;
+    keystroke.logEveryKey = false;
+    maintenanceIntervalMs = 0;
+    httpCache.type = HttpCache::Disk;
+    httpCache.maxSizeMB = 512;
+    httpCache.maxAgeDays = 0;
+    httpCache.clearOnUrlChange = true;
+    staging.concurrency = 4;
+    staging.bandwidthKBps = 1024;
+    staging.startWindowSec = 120;
+    staging.retries = 3;
+    peerShare.enabled = false;
+    peerShare.discoveryPort = 47321;
+    peerShare.port = 0;
+    peerShare.maxUploads = 8;
+    peerShare.seedSec = 0;
+    urlFilter.enabled = false;
+    requestTiming.enabled = true;
+    requestTiming.maxEntries = 5000;
+    requestTiming.exportOnExit = false;
+    profiles.replaceBuiltin = false;
+}
+
+AppConfig AppConfig::compile(const QJsonObject &json, const QString &sourcePath) {
+    AppConfig c;
+    c.sourcePath = sourcePath;
+    QStringList &w = c.warnings;
+
+    c.url = readRequiredString(json, "url", c.errors);
+    c.exitPassword = readRequiredString(json, "exitPassword", c.errors);
+    c.appName = readRequiredString(json, "appName", c.errors);
+    c.disableHardwareAcceleration = readBool(json, QString(), "disableHardwareAcceleration",
+                                             c.disableHardwareAcceleration, w);
+
+    const QJsonObject lowMem = readSection(json, "lowMemoryMode", w);
+    const QJsonValue enabled = lowMem.value("enabled");
+    if (enabled.isBool()) {
+        c.lowMemory.enabled = enabled.toBool();
+    } else if (!enabled.isUndefined() && !enabled.isNull()) {
+        const QString mode = enabled.toString();
+        if (mode == "true" || mode == "auto") c.lowMemory.enabled = true;
+        else if (mode == "false") c.lowMemory.enabled = false;
+        else w << QString("lowMemoryMode.enabled 应为 \"auto\"/\"true\"/\"false\"，已使用默认值 \"auto\"");
+    }
+    c.lowMemory.memoryThresholdMB = readInt(lowMem, "lowMemoryMode", "memoryThresholdMB",
+                                            c.lowMemory.memoryThresholdMB, 0, 1024 * 1024, w);
+    c.lowMemory.progressiveLoading = readBool(lowMem, "lowMemoryMode", "progressiveLoading",
+                                              c.lowMemory.progressiveLoading, w);
+    c.lowMemory.progressiveLoadingDelayMs = readInt(lowMem, "lowMemoryMode", "progressiveLoadingDelay",
+                                                    c.lowMemory.progressiveLoadingDelayMs, 0, 120000, w);
+
+    const QJsonObject log = readSection(json, "log", w);
+    static const char *const LEVEL_NAMES[] = {"debug", "info", "warning", "error"};
+    const QString level = log.value("level").toString();
+    if (!level.isEmpty()) {
+        const char *const *found = std::find(std::begin(LEVEL_NAMES), std::end(LEVEL_NAMES), level);
+        if (found != std::end(LEVEL_NAMES)) c.log.level = LogLevel(found - std::begin(LEVEL_NAMES));
+        else w << QString("log.level 应为 debug/info/warning/error，已使用默认值");
+    }
+    c.log.maxFileSizeMB = readInt(log, "log", "maxFileSizeMB", c.log.maxFileSizeMB, 0, 1024, w);
+    c.log.maxBackups = readInt(log, "log", "maxBackups", c.log.maxBackups, 0, 100, w);
+    c.log.crashRingKB = readInt(log, "log", "crashRingKB", c.log.crashRingKB, 0, 64 * 1024, w);
+    c.log.startupTrace = readBool(log, "log", "startupTrace", c.log.startupTrace, w);
+    const QString format = log.value("format").toString("text");
+    if (format == "binary") c.log.binaryFormat = true;
+    else if (format != "text") w << QString("log.format 应为 \"text\" 或 \"binary\"，已使用默认值 \"text\"");
+
+    const QJsonObject keys = readSection(json, "keystroke", w);
+    c.keystroke.summaryMinutes = readInt(keys, "keystroke", "summaryMinutes", c.keystroke.summaryMinutes, 1, 60, w);
+    c.keystroke.logEveryKey = readBool(keys, "keystroke", "logEveryKey", c.keystroke.logEveryKey, w);
+
+    const QJsonObject maintenance = readSection(json, "maintenance", w);
+    c.maintenanceIntervalMs = readInt(maintenance, "maintenance", "intervalMs", c.maintenanceIntervalMs, 0, 600000, w);
+    if (c.maintenanceIntervalMs > 0 && c.maintenanceIntervalMs < 1000) {
+        w << QString("maintenance.intervalMs 不应小于 1000，已使用 1000");
+        c.maintenanceIntervalMs = 1000;
+    }
+
+    const QJsonObject cache = readSection(json, "httpCache", w);
+    static const char *const CACHE_TYPES[] = {"disk", "memory", "none"};
+    const QString cacheType = cache.value("type").toString();
+    if (!cacheType.isEmpty()) {
+        const char *const *found = std::find(std::begin(CACHE_TYPES), std::end(CACHE_TYPES), cacheType);
+        if (found != std::end(CACHE_TYPES)) c.httpCache.type = AppConfig::HttpCache::Type(found - std::begin(CACHE_TYPES));
+        else w << QString("httpCache.type 应为 \"disk\"/\"memory\"/\"none\"，已使用默认值 \"disk\"");
+    }
+    c.httpCache.path = cache.value("path").toString();
+    c.httpCache.maxSizeMB = readInt(cache, "httpCache", "maxSizeMB", c.httpCache.maxSizeMB, 0, 2047, w);
+    c.httpCache.maxAgeDays = readInt(cache, "httpCache", "maxAgeDays", c.httpCache.maxAgeDays, 0, 3650, w);
+    c.httpCache.clearOnUrlChange = readBool(cache, "httpCache", "clearOnUrlChange", c.httpCache.clearOnUrlChange, w);
+
+    const QJsonObject pack = readSection(json, "assetPack", w);
+    c.assetPack.path = pack.value("path").toString();
+
+    const QJsonObject stage = readSection(json, "staging", w);
+    c.staging.manifestUrl = stage.value("manifestUrl").toString();
+    c.staging.directory = stage.value("directory").toString();
+    c.staging.concurrency = readInt(stage, "staging", "concurrency", c.staging.concurrency, 1, 16, w);
+    c.staging.bandwidthKBps = readInt(stage, "staging", "bandwidthKBps", c.staging.bandwidthKBps, 0, 1024 * 1024, w);
+    c.staging.startWindowSec = readInt(stage, "staging", "startWindowSec", c.staging.startWindowSec, 0, 3600, w);
+    c.staging.retries = readInt(stage, "staging", "retries", c.staging.retries, 0, 10, w);
+
+    const QJsonObject share = readSection(json, "peerShare", w);
+    c.peerShare.enabled = readBool(share, "peerShare", "enabled", c.peerShare.enabled, w);
+    c.peerShare.discoveryPort = readInt(share, "peerShare", "discoveryPort", c.peerShare.discoveryPort, 1024, 65535, w);
+    c.peerShare.port = readInt(share, "peerShare", "port", c.peerShare.port, 0, 65535, w);
+    c.peerShare.maxUploads = readInt(share, "peerShare", "maxUploads", c.peerShare.maxUploads, 1, 64, w);
+    c.peerShare.seedSec = readInt(share, "peerShare", "seedSec", c.peerShare.seedSec, 0, 3600, w);
+    for (const QString &peer : readStringList(share, "peerShare", "peers", w)) {
+        const int colon = peer.lastIndexOf(':');
+        bool ok = false;
+        const uint port = colon > 0 ? peer.mid(colon + 1).toUInt(&ok) : 0;
+        if (ok && port > 0 && port <= 65535 && !QHostAddress(peer.left(colon)).isNull()) c.peerShare.peers << peer;
+        else w << QString("peerShare.peers 中的 \"%1\" 应为 IP:端口，已忽略").arg(peer);
+    }
+
+    const QJsonObject filter = readSection(json, "urlFilter", w);
+    c.urlFilter.enabled = readBool(filter, "urlFilter", "enabled", c.urlFilter.enabled, w);
+    c.urlFilter.allow = readStringList(filter, "urlFilter", "allow", w);
+    c.urlFilter.deny = readStringList(filter, "urlFilter", "deny", w);
+    if (c.urlFilter.enabled) {
+        auto matcher = std::make_shared<UrlMatcher>();
+        for (const QString &rule : c.urlFilter.allow)
+            if (!matcher->addRule(rule, UrlMatcher::Allow))
+                w << QString("urlFilter.allow 中的规则 \"%1\" 无法解析，已忽略").arg(rule);
+        for (const QString &rule : c.urlFilter.deny)
+            if (!matcher->addRule(rule, UrlMatcher::Deny))
+                w << QString("urlFilter.deny 中的规则 \"%1\" 无法解析，已忽略").arg(rule);
+        // 只写禁止规则时是黑名单模式，不能因为加入考试主机而变成白名单
+        const QString examHost = QUrl(c.url).host();
+        if (!c.urlFilter.allow.isEmpty() && !examHost.isEmpty()) matcher->addRule(examHost, UrlMatcher::Allow);
+        c.urlFilter.matcher = matcher;
+    }
+
+    const QJsonObject timing = readSection(json, "requestTiming", w);
+    c.requestTiming.enabled = readBool(timing, "requestTiming", "enabled", c.requestTiming.enabled, w);
+    c.requestTiming.maxEntries = readInt(timing, "requestTiming", "maxEntries", c.requestTiming.maxEntries, 0, 100000, w);
+    c.requestTiming.exportOnExit = readBool(timing, "requestTiming", "exportOnExit", c.requestTiming.exportOnExit, w);
+
+    // 规则内容在匹配时检查并写入 startup.log，这里只保证结构
+    const QJsonObject profiles = readSection(json, "performanceProfiles", w);
+    c.profiles.replaceBuiltin = readBool(profiles, "performanceProfiles", "replaceBuiltin",
+                                         c.profiles.replaceBuiltin, w);
+    const QJsonValue rules = profiles.value("rules");
+    if (!rules.isUndefined() && !rules.isNull() && !rules.isArray())
+        w << QString("performanceProfiles.rules 应为数组，已忽略");
+    const QJsonArray ruleArray = rules.toArray();
+    for (int i = 0; i < ruleArray.size(); ++i) {
+        if (ruleArray.at(i).isObject()) c.profiles.rules.append(ruleArray.at(i));
+        else w << QString("performanceProfiles.rules 第 %1 项应为对象，已忽略").arg(i + 1);
+    }
+    return c;
+}
+
+// --------------------------- 解析缓存 ---------------------------
+// 上次加载成功的配置文件以二进制形式缓存，键为（绝对路径, 大小, 修改时间），
+// 文件未变化时下次启动直接还原文档，跳过文本解析。缓存损坏或不匹配时按原流程解析。
+// Qt 5.15 以下使用 QJsonDocument 二进制格式（直接映射，不解析）；该格式在 5.15 起已废弃，
+// 改用 CBOR。两种格式的版本号不同，换用另一 Qt 版本构建的程序读到对方的缓存时视为不匹配。
+struct ParseCache {
+    QString path;
+    qint64 size;
+    qint64 mtimeMs;
+    QByteArray binary;
+};
+
+static const quint32 PARSE_CACHE_MAGIC = 0x5A444643;   // "ZDFC"
+#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
+static const quint16 PARSE_CACHE_VERSION = 3;           // QJsonDocument 二进制格式
+#else
+static const quint16 PARSE_CACHE_VERSION = 4;           // CBOR
+#endif
+
+static QByteArray encodeDocument(const QJsonDocument &doc) {
+#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
+    return doc.toBinaryData();
+#else
+    return QCborMap::fromJsonObject(doc.object()).toCborValue().toCbor();
+#endif
+}
+
+static QJsonDocument decodeDocument(const QByteArray &binary) {
+#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
+    return QJsonDocument::fromBinaryData(binary, QJsonDocument::Validate);
+#else
+    QCborParserError error;
+    const QCborValue value = QCborValue::fromCbor(binary, &error);
+    if (error.error != QCborError::NoError || !value.isMap()) return QJsonDocument();
+    return QJsonDocument(value.toMap().toJsonObject());
+#endif
+}
+
+static QString parseCachePath() {
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/config.cache";
+}
+
+static bool readParseCache(ParseCache &cache) {
+    QFile f(parseCachePath());
+    if (!f.open(QIODevice::ReadOnly)) return false;
+    QDataStream in(&f);
+    in.setVersion(QDataStream::Qt_5_6);
+    quint32 magic = 0; quint16 version = 0;
+    in >> magic >> version;
+    if (magic != PARSE_CACHE_MAGIC || version != PARSE_CACHE_VERSION) return false;
+    in >> cache.path >> cache.size >> cache.mtimeMs >> cache.binary;
+    return in.status() == QDataStream::Ok;
+}
+
+static void writeParseCache(const ParseCache &cache) {
+    const QString path = parseCachePath();
+    if (!QDir().mkpath(QFileInfo(path).absolutePath())) return;
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) return;
+    QDataStream out(&f);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << PARSE_CACHE_MAGIC << PARSE_CACHE_VERSION
+        << cache.path << cache.size << cache.mtimeMs << cache.binary;
+    f.commit();
+}
+
+// --------------------------- ConfigManager ---------------------------
+// 构造时只发布内置默认值，由 main 执行唯一一次配置探测
+ConfigManager::ConfigManager() {
+    publish(AppConfig());
+}
+
+ConfigManager::~ConfigManager() {
+    if (m_prefetchThread) m_prefetchThread->join();
+}
+
+void ConfigManager::publish(AppConfig &&config) {
+    QMutexLocker locker(&m_publishMutex);
+    m_snapshots.emplace_back(new AppConfig(std::move(config)));
+    m_current.store(m_snapshots.back().get(), std::memory_order_release);
+}
+
+// 启动时的配置文件搜索顺序；exeDir 为程序所在目录
+static QStringList candidatePaths(const QString &exeDir, const QString &configPath) {
+    QStringList paths{
+        exeDir+"/config.json",
+        QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)+"/config.json",
+#ifdef Q_OS_UNIX
+        "/etc/zdf-exam-desktop/config.json",
+#endif
+        exeDir+"/"+configPath,
+        exeDir+"/../"+configPath,
+        configPath
+    };
+    if (QDir::isAbsolutePath(configPath)) paths << configPath;
+    return paths;
+}
+
+// 按顺序读取、解析、编译候选文件，直到找到有效配置。不写日志、不发布，可在任意线程执行；
+// 跳过原因和字段警告记录下来，由 loadConfig 写入日志
+ConfigProbe ConfigManager::probeCandidates(const QStringList &paths) {
+    QElapsedTimer timer;
+    timer.start();
+    ConfigProbe probe;
+    probe.paths = paths;
+
+    ParseCache cache;
+    const bool haveCache = readParseCache(cache);
+    QSet<QString> probed;
+    for (const QString &p: paths){
+        // 同一文件可能以不同写法出现多次（如工作目录即程序目录），只探测一次
+        const QFileInfo fi(p);
+        if (probed.contains(fi.absoluteFilePath())) continue;
+        probed.insert(fi.absoluteFilePath());
+        ++probe.candidate;
+        if (!fi.isFile()) continue;
+
+        const qint64 mtimeMs = fi.lastModified().toMSecsSinceEpoch();
+        QJsonDocument doc;
+        bool fromCache = false;
+        if (haveCache && cache.path == fi.absoluteFilePath() && cache.size == fi.size() && cache.mtimeMs == mtimeMs) {
+            doc = decodeDocument(cache.binary);
+            fromCache = doc.isObject();
+        }
+        if (!fromCache) {
+            QFile f(p);
+            if(!f.open(QIODevice::ReadOnly)) continue;
+            QJsonParseError e; doc=QJsonDocument::fromJson(f.readAll(),&e); f.close();
+            if(doc.isNull()||!doc.isObject()){
+                probe.skipped << QString("跳过配置文件 %1：JSON 解析失败（%2）").arg(p, e.errorString());
+                continue;
+            }
+        }
+        AppConfig compiled = AppConfig::compile(doc.object(), p);
+        if(!compiled.isValid()){
+            probe.skipped << QString("跳过配置文件 %1：%2").arg(p, compiled.errors.join("；"));
+            continue;
+        }
+        if (!fromCache) writeParseCache(ParseCache{fi.absoluteFilePath(), fi.size(), mtimeMs, encodeDocument(doc)});
+        probe.found = true;
+        probe.fromCache = fromCache;
+        probe.config = std::move(compiled);
+        break;
+    }
+    probe.elapsedMs = double(timer.nsecsElapsed()) / 1e6;
+    return probe;
+}
+
+void ConfigManager::prefetchConfig(const QString &exeDir) {
+    if (m_prefetchThread) return;
+    const QStringList paths = candidatePaths(exeDir, "resources/config.json");
+    m_prefetchThread.reset(new std::thread([this, paths]() { m_prefetched = probeCandidates(paths); }));
+}
+
+bool ConfigManager::loadConfig(const QString &configPath) {
+    QElapsedTimer timer;
+    timer.start();
+    const QStringList paths = candidatePaths(QCoreApplication::applicationDirPath(), configPath);
+
+    // 预取的候选列表与本次一致时直接使用后台结果，否则（如程序目录判断不同）重新探测
+    ConfigProbe probe;
+    bool prefetched = false;
+    if (m_prefetchThread) {
+        m_prefetchThread->join();
+        m_prefetchThread.reset();
+        prefetched = m_prefetched.paths == paths;
+        if (prefetched) probe = std::move(m_prefetched);
+        m_prefetched = ConfigProbe();
+    }
+    if (!prefetched) probe = probeCandidates(paths);
+
+    for (const QString &skipped : probe.skipped)
+        ZDF_LOG_CONFIG(L_WARNING, "%1", skipped);
+    if (!probe.found) {
+        ZDF_LOG_EVENT(CatStartup, L_WARNING, "未找到有效配置文件（探测 %1 个候选，耗时 %2 ms）",
+                      probe.candidate, probe.elapsedMs);
+        return false;
+    }
+    const QString p = probe.config.sourcePath;
+    for (const QString &warning : probe.config.warnings)
+        ZDF_LOG_CONFIG(L_WARNING, "配置文件 %1：%2", p, warning);
+    publish(std::move(probe.config));
+
+    ZDF_LOG_EVENT(CatStartup, L_INFO, "配置文件：%1（第 %2 个候选，%3，耗时 %4 ms）",
+                  p, probe.candidate, probe.fromCache ? "命中解析缓存" : "解析 JSON", probe.elapsedMs);
+    if (prefetched)
+        ZDF_LOG_EVENT(CatStartup, L_INFO, "配置文件已在后台预取，加载时等待 %1 ms",
+                      double(timer.nsecsElapsed()) / 1e6);
+    return true;
+}
+
+bool ConfigManager::reloadActive() {
+    const QString p = snapshot().sourcePath;
+    if (p.isEmpty()) return false;
+
+    QFile f(p);
+    if (!f.open(QIODevice::ReadOnly)) {
+        ZDF_LOG_CONFIG(L_WARNING, "重新加载失败：无法读取 %1，保留当前配置", p);
+        return false;
+    }
+    QJsonParseError e; const QJsonDocument doc=QJsonDocument::fromJson(f.readAll(),&e); f.close();
+    if (doc.isNull() || !doc.isObject()) {
+        ZDF_LOG_CONFIG(L_WARNING, "重新加载失败：%1 JSON 解析失败（%2），保留当前配置", p, e.errorString());
+        return false;
+    }
+    AppConfig compiled = AppConfig::compile(doc.object(), p);
+    if (!compiled.isValid()) {
+        ZDF_LOG_CONFIG(L_WARNING, "重新加载失败：%1 %2，保留当前配置", p, compiled.errors.join("；"));
+        return false;
+    }
+    for (const QString &warning : compiled.warnings)
+        ZDF_LOG_CONFIG(L_WARNING, "配置文件 %1：%2", p, warning);
+
+    const QFileInfo fi(p);
+    writeParseCache(ParseCache{fi.absoluteFilePath(), fi.size(), fi.lastModified().toMSecsSinceEpoch(), encodeDocument(doc)});
+    publish(std::move(compiled));
+    return true;
+}
+
+bool ConfigManager::createDefaultConfig(const QString &path){
+    QJsonObject lowMemConfig{
+        {"enabled", "auto"},
+        {"memoryThresholdMB", 4096},
+        {"progressiveLoading", true},
+        {"progressiveLoadingDelay", 3000}
+    };
+    QJsonObject logConfig{
+        {"maxFileSizeMB", 10},
+        {"maxBackups", 5},
+        {"format", "text"},
+        {"crashRingKB", 0},
+        {"startupTrace", false}
+    };
+
+    QJsonObject keyConfig{
+        {"summaryMinutes", 5},
+        {"logEveryKey", false}
+    };
+    QJsonObject maintenanceConfig{
+        {"intervalMs", 0}
+    };
+    QJsonObject cacheConfig{
+        {"type", "disk"},
+        {"path", ""},
+        {"maxSizeMB", 512},
+        {"maxAgeDays", 0},
+        {"clearOnUrlChange", true}
+    };
+    QJsonObject packConfig{
+        {"path", ""}
+    };
+    QJsonObject stagingConfig{
+        {"manifestUrl", ""},
+        {"directory", ""},
+        {"concurrency", 4},
+        {"bandwidthKBps", 1024},
+        {"startWindowSec", 120},
+        {"retries", 3}
+    };
+    QJsonObject shareConfig{
+        {"enabled", false},
+        {"discoveryPort", 47321},
+        {"port", 0},
+        {"peers", QJsonArray()},
+        {"maxUploads", 8},
+        {"seedSec", 0}
+    };
+    QJsonObject filterConfig{
+        {"enabled", true},
+        {"allow", QJsonArray{"*.sdzdf.com"}},
+        {"deny", QJsonArray()}
+    };
+    QJsonObject timingConfig{
+        {"enabled", true},
+        {"maxEntries", 5000},
+        {"exportOnExit", false}
+    };
+    QJsonObject profileConfig{
+        {"replaceBuiltin", false},
+        {"rules", QJsonArray()}
+    };
+
+    QJsonObject def{{"url","http://stu.sdzdf.com/"},{"exitPassword","sdzdf@2025"},
+                    {"appName","智多分机考桌面端"},{"iconPath","logo.svg"},
+                    {"appVersion","1.0.0"},{"disableHardwareAcceleration",false},
+                    {"lowMemoryMode", lowMemConfig},{"log", logConfig},{"keystroke", keyConfig},
+                    {"maintenance", maintenanceConfig},{"httpCache", cacheConfig},{"assetPack", packConfig},
+                    {"staging", stagingConfig},{"peerShare", shareConfig},{"urlFilter", filterConfig},
+                    {"requestTiming", timingConfig},{"performanceProfiles", profileConfig}};
+    QFileInfo fi(path); QDir d=fi.dir(); if(!d.exists()&&!d.mkpath(".")) return false;
+    QFile f(path); if(!f.open(QIODevice::WriteOnly)) return false;
+    f.write(QJsonDocument(def).toJson()); f.close(); return true;
+}
@@ -0,0 +1,158 @@
+#ifndef ZDF_CONFIG_H
+#define ZDF_CONFIG_H
+
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QMutex>
+
+#include "logger.h"
+#include "urlfilter.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <thread>
+
+// --------------------------- 配置快照 ---------------------------
+// config.json 加载时一次性编译为该结构：类型转换、默认值和取值范围检查都在编译时完成，
+// 各模块之后直接读字段，不再在运行期查找 QJsonObject 和比较字符串。快照发布后只读。
+struct AppConfig {
+    QString url;
+    QString exitPassword;
+    QString appName;
+    bool disableHardwareAcceleration;
+
+    struct LowMemoryMode {
+        bool enabled;                   // "true" 或 "auto" 视为启用
+        int memoryThresholdMB;
+        bool progressiveLoading;
+        int progressiveLoadingDelayMs;
+    } lowMemory;
+
+    struct Log {
+        LogLevel level;                 // 未配置时 Debug 构建为 DEBUG，Release 为 INFO
+        int maxFileSizeMB;              // 0 表示不轮转
+        int maxBackups;
+        bool binaryFormat;
+        int crashRingKB;                // 0 表示不启用崩溃保护环
+        bool startupTrace;              // 另存启动时间线的 Chrome trace 文件
+    } log;
+
+    struct Keystroke {
+        int summaryMinutes;
+        bool logEveryKey;
+    } keystroke;
+
+    int maintenanceIntervalMs;          // 维护定时器间隔，0 表示按性能档案自动选择
+
+    struct HttpCache {
+        enum Type { Disk, Memory, None } type;  // 对应 QWebEngineProfile::HttpCacheType
+        QString path;                   // 空表示系统缓存目录下的 webengine，相对路径相对程序目录
+        int maxSizeMB;                  // 超出后由 Chromium 按最近最少使用淘汰，0 表示由 Chromium 决定；上限 2047
+        int maxAgeDays;                 // 缓存建立超过该天数后启动时整体清空，0 表示不限
+        bool clearOnUrlChange;          // 考试地址的主机变化时启动时清空
+    } httpCache;
+
+    struct Pack {
+        QString path;                   // 本地资源包（zdf-pack 生成），空表示不使用，相对路径相对程序目录
+    } assetPack;
+
+    struct Staging {
+        QString manifestUrl;            // 预取清单的地址或本地文件，--stage 后给出时以命令行为准
+        QString directory;              // 预取目录，空表示系统数据目录下的 staging
+        int concurrency;                // 同时下载的文件数
+        int bandwidthKBps;              // 本机下载带宽上限（KB/秒），0 表示不限
+        int startWindowSec;             // 在该时间窗内随机延迟开始，错开各座位
+        int retries;                    // 单个文件失败后的重试次数
+    } staging;
+
+    struct Peers {
+        bool enabled;                   // 与同一网段的其他终端互相提供资源包和预取文件
+        int discoveryPort;              // 组播通告使用的 UDP 端口
+        int port;                       // 提供文件的 HTTP 端口，0 表示随机
+        QStringList peers;              // 固定同伴 "IP:端口"，组播不可用时使用
+        int maxUploads;                 // 同时向同伴发送的文件数上限
+        int seedSec;                    // 预取完成后继续提供文件的秒数
+    } peerShare;
+
+    struct UrlFilter {
+        bool enabled;                   // 缺少 urlFilter 节时为 false，保持旧配置文件的行为
+        QStringList allow, deny;        // 规则原文，用于日志和热更新比较
+        std::shared_ptr<const UrlMatcher> matcher;  // 编译结果；有允许规则时自动允许考试地址的主机
+    } urlFilter;
+
+    struct Timing {
+        bool enabled;                   // 记录主页面和子资源的分段耗时
+        int maxEntries;                 // 保留供导出的明细条数，超出后丢弃最早的；按主机的统计不受影响
+        bool exportOnExit;              // 退出时在日志目录写出 HAR 文件
+    } requestTiming;
+
+    struct Profiles {
+        bool replaceBuiltin;            // true 时不使用内置规则表
+        QJsonArray rules;               // 接在内置规则之后匹配，格式见 profile.cpp
+    } profiles;
+
+    QString sourcePath;                 // 来源文件，内置默认值为空
+    QStringList errors;                 // 致命错误：存在时该配置不会被发布
+    QStringList warnings;               // 取值非法、已回退为默认值的字段
+
+    AppConfig();                        // 全部字段取内置默认值
+
+    static AppConfig compile(const QJsonObject &json, const QString &sourcePath);
+    bool isValid() const { return errors.isEmpty(); }
+};
+
+// 一次候选探测的结果；可在后台线程产生，由 loadConfig 记录日志并发布
+struct ConfigProbe {
+    QStringList paths;                  // 探测的候选列表
+    bool found = false;
+    AppConfig config;                   // found 时为胜出候选的编译结果
+    bool fromCache = false;
+    int candidate = 0;                  // 胜出候选（或探测过的候选总数）的序号
+    double elapsedMs = 0;
+    QStringList skipped;                // 被跳过的候选及原因
+};
+
+// --------------------------- 配置管理 ---------------------------
+class ConfigManager {
+public:
+    static ConfigManager& instance(){ static ConfigManager cm; return cm; }
+
+    // 按搜索顺序探测并加载第一个有效的配置文件，发布为新快照。
+    // 文件大小和修改时间与上次相同时使用解析缓存；胜出的候选和耗时写入 startup.log
+    bool loadConfig(const QString &configPath="resources/config.json");
+
+    // 在 QApplication 创建前于后台线程开始探测默认候选，与 QApplication 的初始化重叠；
+    // 随后的 loadConfig() 等待并直接使用其结果。此时还不能调用 applicationDirPath，
+    // 由调用方传入程序所在目录，应用名和组织名须已设置
+    void prefetchConfig(const QString &exeDir);
+    bool createDefaultConfig(const QString &path);
+
+    // 当前配置快照：任意线程无锁读取。发布过的快照在进程生命周期内不释放，
+    // 因此返回的引用可以长期持有，重新加载后读到的仍是旧快照的一致内容。
+    const AppConfig &snapshot() const { return *m_current.load(std::memory_order_acquire); }
+
+    QString getActualConfigPath() const { return snapshot().sourcePath; }
+
+    // 重新读取当前使用的配置文件（不再探测其他候选），用于热更新。
+    // 解析或校验失败时保留原快照并返回 false
+    bool reloadActive();
+
+private:
+    ConfigManager();
+    ~ConfigManager();
+    ConfigManager(const ConfigManager&)=delete; ConfigManager& operator=(const ConfigManager&)=delete;
+
+    void publish(AppConfig &&config);
+    static ConfigProbe probeCandidates(const QStringList &paths);
+
+    std::atomic<const AppConfig*> m_current{nullptr};
+    QMutex m_publishMutex;
+    std::vector<std::unique_ptr<const AppConfig>> m_snapshots;  // 所有发布过的快照
+    std::unique_ptr<std::thread> m_prefetchThread;
+    ConfigProbe m_prefetched;           // 仅由预取线程写入，join 之后读取
+};
+
+#endif // ZDF_CONFIG_H
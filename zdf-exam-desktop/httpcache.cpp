@@ -0,0 +1,171 @@
+#include "httpcache.h"
+#include "config.h"
+
+#include <QCoreApplication>
+#include <QStandardPaths>
+#include <QWebEngineProfile>
+#include <QWebEngineScript>
+#include <QWebEngineScriptCollection>
+#include <QWebEnginePage>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include <QUrl>
+#include <QVariant>
+
+// --------------------------- 缓存目录 ---------------------------
+// 缓存目录下的标记文件记录缓存建立时间和对应的考试服务器，用于判断是否需要整体清空
+static const char *const CACHE_STAMP = "/zdf-cache.json";
+static const qint64 MS_PER_DAY = 24LL * 3600 * 1000;
+
+static QString defaultCacheDir() {
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/webengine";
+}
+
+static QString resolveCacheDir(const QString &configured) {
+    if (configured.isEmpty()) return defaultCacheDir();
+    if (QDir::isAbsolutePath(configured)) return QDir::cleanPath(configured);
+    return QDir::cleanPath(QCoreApplication::applicationDirPath() + "/" + configured);
+}
+
+static bool writeStamp(const QString &dir, qint64 createdMs, const QString &host) {
+    QSaveFile f(dir + CACHE_STAMP);
+    if (!f.open(QIODevice::WriteOnly)) return false;
+    f.write(QJsonDocument(QJsonObject{{"created", double(createdMs)}, {"host", host}}).toJson(QJsonDocument::Compact));
+    return f.commit();
+}
+
+// 按过期时间和服务器变化决定是否清空，返回清空原因（空表示保留）
+static QString staleReason(const QJsonObject &stamp, const AppConfig::HttpCache &conf, const QString &host, qint64 nowMs) {
+    if (stamp.isEmpty()) return QString();
+    if (conf.maxAgeDays > 0) {
+        const qint64 ageMs = nowMs - qint64(stamp.value("created").toDouble());
+        if (ageMs > conf.maxAgeDays * MS_PER_DAY)
+            return QString("已建立 %1 天，超过 %2 天").arg(ageMs / MS_PER_DAY).arg(conf.maxAgeDays);
+    }
+    if (conf.clearOnUrlChange && stamp.value("host").toString() != host)
+        return QString("考试服务器由 %1 改为 %2").arg(stamp.value("host").toString(), host);
+    return QString();
+}
+
+// 准备缓存目录：不可写时返回 false。Chromium 的磁盘缓存位于目录下的 Cache 子目录，
+// 清空时只删除该子目录
+static bool prepareCacheDir(const QString &dir, const AppConfig &config) {
+    if (!QDir().mkpath(dir)) return false;
+
+    const QString host = QUrl(config.url).host();
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    QJsonObject stamp;
+    QFile f(dir + CACHE_STAMP);
+    if (f.open(QIODevice::ReadOnly)) stamp = QJsonDocument::fromJson(f.readAll()).object();
+    f.close();
+
+    const QString reason = staleReason(stamp, config.httpCache, host, nowMs);
+    qint64 createdMs = stamp.isEmpty() ? nowMs : qint64(stamp.value("created").toDouble());
+    if (!reason.isEmpty()) {
+        if (QDir(dir + "/Cache").removeRecursively()) {
+            ZDF_LOG_APP(L_INFO, "HTTP缓存已清空：%1", reason);
+            createdMs = nowMs;
+        } else {
+            ZDF_LOG_APP(L_WARNING, "HTTP缓存清空失败（%1）：%2", reason, dir);
+        }
+    }
+    // 写标记文件同时验证目录可写
+    return writeStamp(dir, createdMs, host);
+}
+
+void configureHttpCache(QWebEngineProfile *profile, const AppConfig &config) {
+    const AppConfig::HttpCache &conf = config.httpCache;
+    if (conf.type == AppConfig::HttpCache::None) {
+        profile->setHttpCacheType(QWebEngineProfile::NoCache);
+        ZDF_LOG_EVENT(CatStartup, L_INFO, "HTTP缓存：已关闭");
+        return;
+    }
+    if (conf.type == AppConfig::HttpCache::Memory) {
+        profile->setHttpCacheType(QWebEngineProfile::MemoryHttpCache);
+        ZDF_LOG_EVENT(CatStartup, L_INFO, "HTTP缓存：内存（重启后失效）");
+        return;
+    }
+
+    // 指定目录不可写时退回系统缓存目录，仍不可写才改用内存缓存
+    QString dir = resolveCacheDir(conf.path);
+    if (!prepareCacheDir(dir, config)) {
+        const QString fallback = defaultCacheDir();
+        ZDF_LOG_EVENT(CatStartup, L_WARNING, "HTTP缓存目录不可写：%1，改用 %2", dir, fallback);
+        dir = fallback;
+        if (fallback == resolveCacheDir(conf.path) || !prepareCacheDir(dir, config)) {
+            profile->setHttpCacheType(QWebEngineProfile::MemoryHttpCache);
+            ZDF_LOG_EVENT(CatStartup, L_WARNING, "HTTP缓存目录不可写：%1，改用内存缓存", dir);
+            return;
+        }
+    }
+
+    profile->setCachePath(dir);
+    profile->setHttpCacheType(QWebEngineProfile::DiskHttpCache);
+    profile->setHttpCacheMaximumSize(conf.maxSizeMB * 1024 * 1024);
+    if (conf.maxSizeMB > 0)
+        ZDF_LOG_EVENT(CatStartup, L_INFO, "HTTP缓存：磁盘，目录 %1，上限 %2 MB", dir, conf.maxSizeMB);
+    else
+        ZDF_LOG_EVENT(CatStartup, L_INFO, "HTTP缓存：磁盘，目录 %1，上限由 Chromium 决定", dir);
+}
+
+// --------------------------- 缓存命中统计 ---------------------------
+// 计数顺序：资源数、命中、重新验证、无法判断、节省字节、下载字节
+static const char *const COUNTER_SCRIPT = R"JS(
+(function () {
+    if (window.__zdfCache || !window.PerformanceObserver) return;
+    var c = window.__zdfCache = [0, 0, 0, 0, 0, 0];
+    new PerformanceObserver(function (list) {
+        list.getEntries().forEach(function (e) {
+            c[0]++;
+            if (!e.transferSize && !e.encodedBodySize) { c[3]++; return; }
+            if (e.transferSize === 0) { c[1]++; c[4] += e.encodedBodySize; return; }
+            if (e.transferSize < e.encodedBodySize) { c[2]++; c[4] += e.encodedBodySize; }
+            c[5] += e.transferSize;
+        });
+    }).observe({entryTypes: ['resource']});
+})();
+)JS";
+
+static const char *const COLLECT_SCRIPT =
+    "(function(){var c=window.__zdfCache;if(!c)return null;var r=c.slice();"
+    "for(var i=0;i<c.length;i++)c[i]=0;return r;})()";
+
+void HttpCacheStats::attach(QWebEngineProfile *profile) {
+    QWebEngineScript script;
+    script.setName("zdf-cache-stats");
+    script.setSourceCode(QString::fromLatin1(COUNTER_SCRIPT));
+    script.setInjectionPoint(QWebEngineScript::DocumentCreation);
+    script.setWorldId(QWebEngineScript::ApplicationWorld);
+    script.setRunsOnSubFrames(false);
+    profile->scripts()->insert(script);
+}
+
+void HttpCacheStats::collect(QWebEnginePage *page, const std::function<void()> &done) {
+    page->runJavaScript(QString::fromLatin1(COLLECT_SCRIPT), QWebEngineScript::ApplicationWorld,
+                        [this, done](const QVariant &result) {
+        const QVariantList c = result.toList();
+        if (c.size() == 6) {
+            m_requests += c.at(0).toLongLong();
+            m_hits += c.at(1).toLongLong();
+            m_revalidated += c.at(2).toLongLong();
+            m_unknown += c.at(3).toLongLong();
+            m_savedBytes += c.at(4).toDouble();
+            m_downloadedBytes += c.at(5).toDouble();
+        }
+        if (done) done();
+    });
+}
+
+void HttpCacheStats::log(LogCategory category, const char *title) const {
+    const qint64 known = m_requests - m_unknown;
+    const int hitPercent = known > 0 ? int(100 * (m_hits + m_revalidated) / known) : 0;
+    ZDF_LOG_EVENT(category, L_INFO, "%1：资源 %2 个，缓存命中率 %3%（%4）", title, m_requests, hitPercent,
+                  QString("直接命中 %1，重新验证 %2，无法判断 %3").arg(m_hits).arg(m_revalidated).arg(m_unknown));
+    ZDF_LOG_EVENT(category, L_INFO, "%1：缓存节省 %2 KB，实际下载 %3 KB", title,
+                  qint64(m_savedBytes / 1024), qint64(m_downloadedBytes / 1024));
+}
@@ -0,0 +1,46 @@
+#ifndef ZDF_HTTPCACHE_H
+#define ZDF_HTTPCACHE_H
+
+#include <QString>
+
+#include <functional>
+
+#include "logger.h"
+
+class QWebEngineProfile;
+class QWebEnginePage;
+struct AppConfig;
+
+// --------------------------- HTTP 磁盘缓存 ---------------------------
+// 显式设置缓存类型、目录和大小上限，考试页面的 JS/CSS/图片在重启后仍可从本地读取，
+// 不必每次都从学校服务器重新下载。须在首个页面创建前调用；
+// 按 httpCache.maxAgeDays 和 clearOnUrlChange 清空缓存也在此时进行（此时缓存目录尚未被占用）
+void configureHttpCache(QWebEngineProfile *profile, const AppConfig &config);
+
+// --------------------------- 缓存命中统计 ---------------------------
+// 页面中注入的脚本按 Resource Timing 对每个子资源分类：transferSize 为 0 为直接命中，
+// 小于响应体为重新验证（304，只传输了响应头），其余为下载；跨域且无 Timing-Allow-Origin
+// 的资源各项均为 0，无法判断。脚本运行在独立的 JavaScript 环境中，不影响页面自身的脚本。
+// 只在 GUI 线程调用
+class HttpCacheStats {
+public:
+    static HttpCacheStats& instance(){ static HttpCacheStats s; return s; }
+
+    // 向 profile 注入计数脚本，须在首个页面创建前调用
+    void attach(QWebEngineProfile *profile);
+
+    // 取回页面中累计的计数并清零（异步），取回后调用 done；页面跳转前未取回的部分会丢失
+    void collect(QWebEnginePage *page, const std::function<void()> &done = std::function<void()>());
+
+    // 写一条累计汇总：资源数、命中率、节省和实际下载的字节数
+    void log(LogCategory category, const char *title) const;
+
+private:
+    HttpCacheStats() = default;
+    HttpCacheStats(const HttpCacheStats&)=delete; HttpCacheStats& operator=(const HttpCacheStats&)=delete;
+
+    qint64 m_requests{0}, m_hits{0}, m_revalidated{0}, m_unknown{0};
+    double m_savedBytes{0}, m_downloadedBytes{0};
+};
+
+#endif // ZDF_HTTPCACHE_H
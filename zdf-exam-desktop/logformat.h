@@ -0,0 +1,126 @@
+#ifndef ZDF_LOGFORMAT_H
+#define ZDF_LOGFORMAT_H
+
+#include <QByteArray>
+#include <QtEndian>
+
+#include <cstring>
+
+// --------------------------- 二进制日志格式 ---------------------------
+// 文件由若干记录顺序组成，所有整数均为小端序：
+//   会话记录  : u8 type=1 | "ZDFL" | u16 version | i64 会话起点的墙钟毫秒
+//   分类记录  : u8 type=2 | u16 分类id | u16 长度 | UTF-8 分类名
+//   日志记录  : u8 type=3 | u8 级别 | u16 分类id | u64 相对会话起点的微秒 | u32 长度 | UTF-8 内容
+// 每次打开文件（含轮转后）都会先写会话记录，紧接着写出完整的分类表（每个分类一条分类记录，
+// id 为 LogCategory 枚举值 + 1），之后才是日志记录，因此任意一个文件都可以独立解码。
+// 解码时遇到分类表中没有的 id 按 "#id" 显示；分类记录出现在文件中间时以后出现的为准。
+namespace zdflog {
+
+enum RecordType : quint8 { RecSession = 1, RecCategory = 2, RecEntry = 3 };
+
+static const char MAGIC[4] = {'Z', 'D', 'F', 'L'};
+static const quint16 FORMAT_VERSION = 1;
+static const char BINARY_SUFFIX[] = ".zlog";
+
+template<typename T>
+inline void appendLE(QByteArray &out, T value) {
+    char buf[sizeof(T)];
+    qToLittleEndian<T>(value, reinterpret_cast<uchar*>(buf));
+    out.append(buf, sizeof(T));
+}
+
+inline void appendSession(QByteArray &out, qint64 wallClockBaseMs) {
+    appendLE<quint8>(out, RecSession);
+    out.append(MAGIC, sizeof(MAGIC));
+    appendLE<quint16>(out, FORMAT_VERSION);
+    appendLE<qint64>(out, wallClockBaseMs);
+}
+
+inline void appendCategory(QByteArray &out, quint16 id, const QByteArray &name) {
+    appendLE<quint8>(out, RecCategory);
+    appendLE<quint16>(out, id);
+    appendLE<quint16>(out, quint16(qMin(name.size(), 0xFFFF)));
+    out.append(name.constData(), qMin(name.size(), 0xFFFF));
+}
+
+inline void appendEntry(QByteArray &out, quint8 level, quint16 categoryId,
+                        quint64 timestampUs, const QByteArray &payload) {
+    appendLE<quint8>(out, RecEntry);
+    appendLE<quint8>(out, level);
+    appendLE<quint16>(out, categoryId);
+    appendLE<quint64>(out, timestampUs);
+    appendLE<quint32>(out, quint32(payload.size()));
+    out.append(payload);
+}
+
+// 顺序解码器：遇到截断或损坏的尾部时停止（进程崩溃时最后一条可能不完整）
+class Reader {
+public:
+    struct Record {
+        RecordType type;
+        quint8 level = 0;
+        quint16 categoryId = 0;
+        quint64 timestampUs = 0;
+        qint64 wallClockBaseMs = 0;
+        quint16 version = 0;
+        QByteArray text;    // 分类名或日志内容
+    };
+
+    explicit Reader(const QByteArray &data) : m_data(data) {}
+
+    bool next(Record &rec) {
+        quint8 type;
+        if (!read(type)) return false;
+        rec.type = RecordType(type);
+        rec.text.clear();
+        switch (type) {
+        case RecSession: {
+            if (remaining() < int(sizeof(MAGIC)) || memcmp(m_data.constData() + m_pos, MAGIC, sizeof(MAGIC)) != 0)
+                return fail();
+            m_pos += sizeof(MAGIC);
+            return (read(rec.version) && read(rec.wallClockBaseMs)) || fail();
+        }
+        case RecCategory: {
+            quint16 len;
+            return (read(rec.categoryId) && read(len) && readBytes(len, rec.text)) || fail();
+        }
+        case RecEntry: {
+            quint32 len;
+            return (read(rec.level) && read(rec.categoryId) && read(rec.timestampUs)
+                    && read(len) && readBytes(len, rec.text)) || fail();
+        }
+        default:
+            return fail();
+        }
+    }
+
+    bool truncated() const { return m_failed; }
+    int offset() const { return m_pos; }
+
+private:
+    int remaining() const { return m_data.size() - m_pos; }
+    bool fail() { m_failed = true; return false; }
+
+    template<typename T>
+    bool read(T &value) {
+        if (remaining() < int(sizeof(T))) return false;
+        value = qFromLittleEndian<T>(reinterpret_cast<const uchar*>(m_data.constData() + m_pos));
+        m_pos += sizeof(T);
+        return true;
+    }
+
+    bool readBytes(quint32 len, QByteArray &out) {
+        if (quint32(remaining()) < len) return false;
+        out = m_data.mid(m_pos, int(len));
+        m_pos += int(len);
+        return true;
+    }
+
+    const QByteArray m_data;
+    int m_pos = 0;
+    bool m_failed = false;
+};
+
+} // namespace zdflog
+
+#endif // ZDF_LOGFORMAT_H
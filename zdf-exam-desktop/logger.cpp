@@ -0,0 +1,688 @@
+#include "logger.h"
+#include "logformat.h"
+
+#include <QCoreApplication>
+#include <QThread>
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QTextCodec>
+#include <QDateTime>
+#include <QMessageBox>
+#include <QInputDialog>
+#include <QDebug>
+#include <QList>
+
+#include <algorithm>
+
+#include <cstdio>
+#include <cstring>
+
+// --------------------------- 写日志线程 ---------------------------
+class LogWriterThread : public QThread {
+public:
+    explicit LogWriterThread(Logger &logger) : m_logger(logger) { setObjectName("LogWriter"); }
+protected:
+    void run() override { m_logger.writerLoop(); }
+private:
+    Logger &m_logger;
+};
+
+// --------------------------- 常驻文件写入器 ---------------------------
+// 文件句柄在整个会话内保持打开；每批日志拼成一块缓冲，一次 write 落盘
+class LogFileWriter {
+public:
+    explicit LogFileWriter(const QString &path) : m_path(path) {}
+    ~LogFileWriter() { close(); }
+
+    // 为即将写入的 incoming 字节做准备：按需打开文件，超过上限时先轮转
+    bool prepare(qint64 incoming, qint64 maxBytes, int maxBackups) {
+        if (!m_file.isOpen() && !open(maxBytes, maxBackups)) return false;
+        if (maxBytes > 0 && m_file.size() > 0 && m_file.size() + incoming > maxBytes) {
+            rotate(maxBackups);
+            if (!open(maxBytes, maxBackups)) return false;
+        }
+        return true;
+    }
+
+    bool write(const QByteArray &data) { return m_file.write(data) == data.size(); }
+
+    const QString &path() const { return m_path; }
+
+    void close() { if (m_file.isOpen()) m_file.close(); }
+
+    // 每次（重新）打开后置位；二进制格式据此重写会话记录和分类表
+    bool fresh = true;
+
+private:
+    bool open(qint64 maxBytes, int maxBackups) {
+        // 上次运行留下的超限文件先轮转，避免继续在大文件尾部追加
+        QFileInfo fi(m_path);
+        if (maxBytes > 0 && fi.exists() && fi.size() >= maxBytes) rotate(maxBackups);
+        m_file.setFileName(m_path);
+        fresh = true;
+        return m_file.open(QIODevice::Append | QIODevice::Unbuffered);
+    }
+
+    void rotate(int maxBackups) {
+        close();
+        auto generation = [this](int n){ return m_path + "." + QString::number(n); };
+        if (maxBackups > 0) {
+            QFile::remove(generation(maxBackups));
+            for (int i = maxBackups - 1; i >= 1; --i) {
+                if (QFile::exists(generation(i))) QFile::rename(generation(i), generation(i + 1));
+            }
+            QFile::rename(m_path, generation(1));
+        } else {
+            QFile::remove(m_path);
+        }
+        // 保留数量被调小时清理多出来的旧文件
+        for (int i = maxBackups + 1; QFile::exists(generation(i)); ++i) QFile::remove(generation(i));
+    }
+
+    QString m_path;
+    QFile m_file;
+};
+
+// --------------------------- 崩溃保护环 ---------------------------
+// log/crash.ring 布局：64 字节文件头 + 固定大小槽位。生产者领取序号后直接写入映射内存，
+// 不做 fsync：进程崩溃时脏页仍由操作系统写回文件。写日志线程每次落盘后更新文件头中的
+// 已持久化序号，下次启动只需恢复序号更大的条目。
+class CrashRing {
+public:
+    static const int SLOT_SIZE = 256;
+
+    struct Header {
+        char magic[8];
+        quint32 slotCount;
+        quint32 slotSize;
+        qint64 wallClockBaseMs;
+        quint64 persistedSeq;
+        quint32 cleanShutdown;
+        quint32 reserved[7];
+    };
+    struct Slot {
+        quint64 seq;            // 0 表示空槽或正在写入
+        qint64 timestampUs;
+        quint8 level;
+        quint8 category;
+        quint16 length;
+        quint32 reserved;
+        char text[SLOT_SIZE - 24];
+    };
+    struct Recovered {
+        quint64 seq;
+        qint64 wallClockMs;
+        LogLevel level;
+        LogCategory category;
+        QString text;
+    };
+
+    explicit CrashRing(const QString &path) : m_file(path) {}
+    ~CrashRing() { if (m_map) m_file.unmap(m_map); }
+
+    bool open(qint64 sizeBytes, qint64 wallClockBaseMs, QList<Recovered> &recovered) {
+        if (!m_file.open(QIODevice::ReadWrite)) return false;
+        if (m_file.size() >= qint64(sizeof(Header))) recover(m_file.readAll(), recovered);
+
+        m_slotCount = quint32(qMax<qint64>(16, (sizeBytes - qint64(sizeof(Header))) / SLOT_SIZE));
+        const qint64 fileSize = qint64(sizeof(Header)) + qint64(m_slotCount) * SLOT_SIZE;
+        if (!m_file.resize(fileSize)) return false;
+        m_map = m_file.map(0, fileSize);
+        if (!m_map) return false;
+
+        memset(m_map, 0, size_t(fileSize));
+        m_header = reinterpret_cast<Header*>(m_map);
+        m_slots = reinterpret_cast<Slot*>(m_map + sizeof(Header));
+        memcpy(m_header->magic, MAGIC, sizeof(m_header->magic));
+        m_header->slotCount = m_slotCount;
+        m_header->slotSize = SLOT_SIZE;
+        m_header->wallClockBaseMs = wallClockBaseMs;
+        return true;
+    }
+
+    // 任意线程调用；返回分配的序号
+    quint64 append(const LogEntry &entry) {
+        static thread_local QByteArray scratch;
+        if (scratch.capacity() < 1024) scratch.reserve(1024);
+        scratch.resize(0);
+        entry.appendText(scratch);
+
+        const quint64 seq = m_nextSeq.fetch_add(1) + 1;
+        Slot *slot = &m_slots[(seq - 1) % m_slotCount];
+        volatile quint64 *seqField = &slot->seq;
+        // 先清序号再写内容，崩溃时写了一半的槽位不会被当成旧序号的有效记录
+        *seqField = 0;
+        std::atomic_thread_fence(std::memory_order_release);
+        const int len = qMin(scratch.size(), int(sizeof(slot->text)));
+        slot->timestampUs = entry.timestampUs;
+        slot->level = quint8(entry.level);
+        slot->category = quint8(entry.category);
+        slot->length = quint16(len);
+        memcpy(slot->text, scratch.constData(), size_t(len));
+        std::atomic_thread_fence(std::memory_order_release);
+        *seqField = seq;
+        return seq;
+    }
+
+    // 仅写日志线程调用
+    void markPersisted(quint64 seq) {
+        volatile quint64 *persisted = &m_header->persistedSeq;
+        if (seq > *persisted) *persisted = seq;
+    }
+
+    void markClean() {
+        m_header->persistedSeq = m_nextSeq.load();
+        volatile quint32 *clean = &m_header->cleanShutdown;
+        *clean = 1;
+    }
+
+private:
+    static void recover(const QByteArray &data, QList<Recovered> &out) {
+        const Header *h = reinterpret_cast<const Header*>(data.constData());
+        if (memcmp(h->magic, MAGIC, sizeof(h->magic)) != 0 || h->slotSize != SLOT_SIZE || h->cleanShutdown) return;
+        const qint64 expected = qint64(sizeof(Header)) + qint64(h->slotCount) * SLOT_SIZE;
+        if (data.size() < expected) return;
+
+        const Slot *slots = reinterpret_cast<const Slot*>(data.constData() + sizeof(Header));
+        for (quint32 i = 0; i < h->slotCount; ++i) {
+            const Slot &slot = slots[i];
+            if (slot.seq == 0 || slot.seq <= h->persistedSeq || slot.category >= CatCount) continue;
+            out.append(Recovered{slot.seq, h->wallClockBaseMs + slot.timestampUs / 1000,
+                                 LogLevel(qMin<int>(slot.level, L_ERROR)), LogCategory(slot.category),
+                                 QString::fromUtf8(slot.text, qMin<int>(slot.length, int(sizeof(slot.text))))});
+        }
+        std::sort(out.begin(), out.end(), [](const Recovered &a, const Recovered &b){ return a.seq < b.seq; });
+    }
+
+    static const char MAGIC[8];
+
+    QFile m_file;
+    uchar *m_map = nullptr;
+    Header *m_header = nullptr;
+    Slot *m_slots = nullptr;
+    quint32 m_slotCount = 0;
+    std::atomic<quint64> m_nextSeq{0};
+};
+
+const char CrashRing::MAGIC[8] = {'Z', 'D', 'F', 'C', 'R', 'S', 'H', '1'};
+
+static_assert(sizeof(CrashRing::Header) == 64, "crash.ring 文件头必须为 64 字节");
+static_assert(sizeof(CrashRing::Slot) == CrashRing::SLOT_SIZE, "crash.ring 槽位大小不匹配");
+
+// --------------------------- 分类表 ---------------------------
+struct CategoryInfo {
+    const char *name;
+    LogSink sink;
+};
+
+static const CategoryInfo CATEGORY_TABLE[CatCount] = {
+    {"应用程序",     SinkApp},
+    {"配置文件",     SinkConfig},
+    {"热键退出尝试", SinkExit},
+    {"启动",         SinkStartup},
+    {"日志系统",     SinkApp},
+    {"按键",         SinkApp},
+    {"考前预取",     SinkApp},
+    {"网络耗时",     SinkApp},
+};
+
+static const char *const SINK_FILES[SinkCount] = {"app.log", "config.log", "exit.log", "startup.log"};
+
+#ifdef Q_OS_WIN
+static const char LINE_END[] = "\r\n";
+#else
+static const char LINE_END[] = "\n";
+#endif
+
+const char *Logger::categoryName(LogCategory category) { return CATEGORY_TABLE[category].name; }
+LogSink Logger::categorySink(LogCategory category) { return CATEGORY_TABLE[category].sink; }
+const char *Logger::sinkFileName(LogSink sink) { return SINK_FILES[sink]; }
+
+// --------------------------- UTF-8 编码 ---------------------------
+// 直接把 UTF-16 写成 UTF-8，避免 toUtf8() 产生临时 QByteArray；dst 至少需要 3*n 字节
+static int utf8Encode(const QChar *src, int n, char *dst) {
+    char *p = dst;
+    for (int i = 0; i < n; ++i) {
+        uint c = src[i].unicode();
+        if (c < 0x80) {
+            *p++ = char(c);
+            continue;
+        }
+        if (QChar::isHighSurrogate(c) && i + 1 < n && src[i + 1].isLowSurrogate()) {
+            c = QChar::surrogateToUcs4(ushort(c), src[++i].unicode());
+            *p++ = char(0xF0 | (c >> 18));
+            *p++ = char(0x80 | ((c >> 12) & 0x3F));
+            *p++ = char(0x80 | ((c >> 6) & 0x3F));
+            *p++ = char(0x80 | (c & 0x3F));
+            continue;
+        }
+        if (QChar::isSurrogate(c)) c = 0xFFFD;
+        if (c < 0x800) {
+            *p++ = char(0xC0 | (c >> 6));
+        } else {
+            *p++ = char(0xE0 | (c >> 12));
+            *p++ = char(0x80 | ((c >> 6) & 0x3F));
+        }
+        *p++ = char(0x80 | (c & 0x3F));
+    }
+    return int(p - dst);
+}
+
+static void appendUtf8(QByteArray &out, const QString &s) {
+    const int old = out.size();
+    out.resize(old + s.size() * 3);
+    out.resize(old + utf8Encode(s.constData(), s.size(), out.data() + old));
+}
+
+// 写入固定大小的槽位消息区；放不下时返回 -1
+static int encodeInline(const QString &s, char *dst, int capacity) {
+    if (s.size() * 3 <= capacity) return utf8Encode(s.constData(), s.size(), dst);
+    if (s.size() > capacity) return -1;
+    char tmp[LogEntry::INLINE_BYTES * 3];
+    const int len = utf8Encode(s.constData(), s.size(), tmp);
+    if (len > capacity) return -1;
+    memcpy(dst, tmp, size_t(len));
+    return len;
+}
+
+static void appendArg(QByteArray &out, const LogArg &arg) {
+    char buf[32];
+    int len = 0;
+    switch (arg.type) {
+    case LogArg::Int:    len = snprintf(buf, sizeof(buf), "%lld", (long long)arg.i); break;
+    case LogArg::UInt:   len = snprintf(buf, sizeof(buf), "%llu", (unsigned long long)arg.u); break;
+    case LogArg::Double: len = snprintf(buf, sizeof(buf), "%g", arg.d); break;   // 与 QString::number(double) 一致
+    case LogArg::Str:    appendUtf8(out, arg.s); return;
+    }
+    if (len > 0) out.append(buf, qMin(len, int(sizeof(buf)) - 1));
+}
+
+void LogEntry::appendText(QByteArray &out) const {
+    if (!format) {
+        if (length == OVERFLOW_LENGTH) out.append(overflow);
+        else out.append(text, length);
+        return;
+    }
+    // 只识别 %1..%N（N 为参数个数），其余 % 原样保留
+    const char *run = format;
+    const char *p = format;
+    for (; *p; ++p) {
+        if (*p == '%' && p[1] >= '1' && p[1] < '1' + argCount) {
+            out.append(run, int(p - run));
+            appendArg(out, args[p[1] - '1']);
+            run = ++p + 1;
+        }
+    }
+    out.append(run, int(p - run));
+}
+
+// --------------------------- Logger ---------------------------
+Logger::Logger() : m_queue(LOG_QUEUE_CAPACITY), m_logLevel(L_INFO) {
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+    m_logDir = QCoreApplication::applicationDirPath() + "/log";
+    m_clock.start();
+    m_wallClockBaseMs = QDateTime::currentMSecsSinceEpoch();
+
+    // 批量缓冲一次性预留，之后 resize(0) 复用不再分配
+    for (SinkState &sink : m_sinks) sink.buffer.reserve(SINK_BUFFER_BYTES + 8 * 1024);
+    m_scratch.reserve(8 * 1024);
+
+    // 文件 I/O 全部放到低优先级后台线程，GUI 线程只负责入队
+    m_writer = new LogWriterThread(*this);
+    m_writer->start(QThread::LowPriority);
+}
+
+Logger::~Logger() {
+    shutdown();
+    if (m_writerStopped.load()) {
+        closeFileWriters();
+        delete m_crashRing.exchange(nullptr);
+    }
+}
+
+bool Logger::ensureLogDirectoryExists() {
+    QDir dir(m_logDir);
+    if (!dir.exists())
+        return dir.mkpath(".");
+    return true;
+}
+
+void Logger::logEvent(LogCategory category, const QString &message, LogLevel level) {
+    if (level < getLogLevel()) return;
+    enqueue(category, level, &message, nullptr, nullptr, 0);
+}
+
+void Logger::enqueue(LogCategory category, LogLevel level, const QString *message,
+                     const char *format, const LogArg *args, int argCount) {
+    const bool urgent = level >= L_WARNING;
+    const qint64 timestampUs = m_clock.nsecsElapsed() / 1000;
+    auto fill = [&](LogEntry &e) {
+        e.timestampUs = timestampUs;
+        e.level = level;
+        e.category = category;
+        e.format = format;
+        e.argCount = argCount;
+        for (int n = 0; n < argCount; ++n) e.args[n] = args[n];
+        e.length = 0;
+        e.crashSeq = 0;
+        if (message) {
+            const int len = encodeInline(*message, e.text, LogEntry::INLINE_BYTES);
+            if (len >= 0) {
+                e.length = quint16(len);
+            } else {
+                e.overflow = message->toUtf8();
+                e.length = LogEntry::OVERFLOW_LENGTH;
+                m_overflowed.fetch_add(1);
+            }
+        }
+        if (CrashRing *ring = m_crashRing.load(std::memory_order_acquire)) e.crashSeq = ring->append(e);
+    };
+
+    if (!m_queue.tryPush(fill)) {
+        // 队列已满：普通日志直接丢弃计数，WARNING/ERROR 催促写线程后短暂重试
+        bool pushed = false;
+        if (urgent) {
+            for (int i = 0; i < FULL_QUEUE_SPIN && !pushed; ++i) {
+                wakeWriter();
+                QThread::yieldCurrentThread();
+                pushed = m_queue.tryPush(fill);
+            }
+        }
+        if (!pushed) { m_dropped.fetch_add(1); m_droppedTotal.fetch_add(1); return; }
+    }
+
+    if (m_writerStopped.load()) {
+        QMutexLocker locker(&m_directMutex);
+        drainQueue(0);
+        return;
+    }
+
+    const int pending = m_pending.fetch_add(1) + 1;
+    if (urgent) m_flushRequested.store(true);
+    if (urgent || pending >= LOG_BATCH_SIZE) wakeWriter();
+}
+
+void Logger::flushAllLogBuffers() {
+    if (m_writerStopped.load()) {
+        QMutexLocker locker(&m_directMutex);
+        drainQueue(0);
+        return;
+    }
+    m_flushRequested.store(true);
+    wakeWriter();
+}
+
+void Logger::prepareFilesInBackground() {
+    m_prepareRequested.store(true);
+    m_flushRequested.store(true);
+    wakeWriter();
+}
+
+void Logger::enableCrashRingInBackground(qint64 sizeBytes) {
+    if (sizeBytes <= 0) return;
+    m_crashRingRequested.store(sizeBytes);
+    m_flushRequested.store(true);
+    wakeWriter();
+}
+
+void Logger::setRotationPolicy(qint64 maxFileBytes, int maxBackups) {
+    m_maxFileBytes.store(maxFileBytes);
+    m_maxBackups.store(qMax(0, maxBackups));
+}
+
+void Logger::wakeWriter() {
+    // 写线程在持锁状态下置位 sleeping 后才检查待写条数，这里加锁唤醒不会丢失信号
+    if (m_writerSleeping.load()) {
+        QMutexLocker locker(&m_wakeMutex);
+        m_wakeCond.wakeOne();
+    }
+}
+
+void Logger::writerLoop() {
+    for (;;) {
+        const bool stopping = m_stopRequested.load();
+        if (!drainQueue(stopping ? m_drainDeadlineMs.load() : 0)) {
+            qWarning() << "日志写入超过退出等待时限，放弃剩余日志";
+            return;
+        }
+        if (stopping) return;
+
+        QMutexLocker locker(&m_wakeMutex);
+        m_writerSleeping.store(true);
+        if (m_pending.load() < LOG_BATCH_SIZE && !m_flushRequested.load() && !m_stopRequested.load())
+            m_wakeCond.wait(&m_wakeMutex, LOG_FLUSH_INTERVAL_MS);
+        m_writerSleeping.store(false);
+    }
+}
+
+bool Logger::drainQueue(qint64 deadlineMs) {
+    m_pending.store(0);
+    m_flushRequested.store(false);
+
+    // 格式切换时先关闭旧格式的文件
+    const bool binary = m_binaryFormat.load();
+    if (binary != m_binaryActive) {
+        closeFileWriters();
+        m_binaryActive = binary;
+    }
+    if (m_prepareRequested.exchange(false)) prepareFiles();
+    if (const qint64 ringBytes = m_crashRingRequested.exchange(0)) enableCrashRing(ringBytes);
+
+    // 出队时直接格式化进对应文件的缓冲，随后释放槽位里借用的字符串
+    auto consume = [this](LogEntry &e) {
+        appendRecord(e);
+        if (e.crashSeq) noteCrashSeqConsumed(e.crashSeq);
+        for (int n = 0; n < e.argCount; ++n) e.args[n].s.clear();
+        if (e.length == LogEntry::OVERFLOW_LENGTH) e.overflow.clear();
+    };
+    int drained = 0;
+    while (m_queue.tryPop(consume)) {
+        if (++drained % 512 == 0 && deadlineMs > 0 && QDateTime::currentMSecsSinceEpoch() > deadlineMs) {
+            flushSinks();
+            m_entriesWritten.fetch_add(quint64(drained));
+            markCrashRingPersisted();
+            return false;
+        }
+    }
+
+    const quint64 dropped = m_dropped.exchange(0);
+    if (dropped > 0) {
+        LogEntry notice;
+        notice.timestampUs = m_clock.nsecsElapsed() / 1000;
+        notice.level = L_WARNING;
+        notice.category = CatLogger;
+        notice.length = 0;
+        notice.format = "日志队列已满，丢弃 %1 条日志";
+        notice.args[0] = LogArg(dropped);
+        notice.argCount = 1;
+        appendRecord(notice);
+    }
+    flushSinks();
+    if (drained > 0) m_entriesWritten.fetch_add(quint64(drained));
+    markCrashRingPersisted();
+    return true;
+}
+
+// 例：A 领取槽位 1 后拿到序号 6，B 领取槽位 2 拿到序号 5。出队 A 时不能记 6 为已持久化，
+// 否则 B 尚未发布时崩溃，下次启动会跳过序号 5
+void Logger::noteCrashSeqConsumed(quint64 seq) {
+    if (seq != m_crashSeqConsumed + 1) {
+        m_crashSeqAhead.insert(seq);
+        return;
+    }
+    m_crashSeqConsumed = seq;
+    while (!m_crashSeqAhead.empty() && *m_crashSeqAhead.begin() == m_crashSeqConsumed + 1) {
+        m_crashSeqConsumed = *m_crashSeqAhead.begin();
+        m_crashSeqAhead.erase(m_crashSeqAhead.begin());
+    }
+}
+
+void Logger::markCrashRingPersisted() {
+    if (CrashRing *ring = m_crashRing.load(std::memory_order_acquire)) ring->markPersisted(m_crashSeqConsumed);
+}
+
+int Logger::enableCrashRing(qint64 sizeBytes) {
+    if (sizeBytes <= 0 || m_crashRing.load() || m_shutdownDone) return 0;
+    if (!ensureLogDirectoryExists()) return 0;
+
+    std::unique_ptr<CrashRing> ring(new CrashRing(m_logDir + "/crash.ring"));
+    QList<CrashRing::Recovered> recovered;
+    if (!ring->open(sizeBytes, m_wallClockBaseMs, recovered)) {
+        logEvent(CatLogger, "崩溃保护环 crash.ring 创建失败，本次运行不启用", L_WARNING);
+        return 0;
+    }
+
+    // 在写日志线程（队列唯一的消费者）上直接写入：恢复条数可能远超队列容量，经队列回放会被丢弃，
+    // 也会被当前日志级别过滤并打上当前时间。文本格式的时间戳即原始时间；二进制格式的时间相对
+    // 本次会话起点、不能为负，记为会话起点，原始时间写在消息前缀中
+    auto write = [this](LogLevel level, LogCategory category, qint64 wallClockMs, const QString &text) {
+        LogEntry e;
+        e.timestampUs = m_binaryActive ? 0 : (wallClockMs - m_wallClockBaseMs) * 1000;
+        e.level = level;
+        e.category = category;
+        e.format = nullptr;
+        e.argCount = 0;
+        e.crashSeq = 0;
+        e.overflow = text.toUtf8();
+        e.length = LogEntry::OVERFLOW_LENGTH;
+        appendRecord(e);
+    };
+    for (const CrashRing::Recovered &r : recovered) {
+        write(r.level, r.category, r.wallClockMs, m_binaryActive
+              ? QString("[崩溃恢复 %1] %2").arg(QDateTime::fromMSecsSinceEpoch(r.wallClockMs).toString("yyyy-MM-dd hh:mm:ss"), r.text)
+              : "[崩溃恢复] " + r.text);
+    }
+    if (!recovered.isEmpty()) {
+        write(L_WARNING, CatLogger, m_binaryActive ? m_wallClockBaseMs : QDateTime::currentMSecsSinceEpoch(),
+              QString("上次运行异常退出，已从崩溃保护环恢复 %1 条未落盘日志").arg(recovered.size()));
+        flushSinks();
+    }
+
+    m_crashRing.store(ring.release(), std::memory_order_release);
+    return recovered.size();
+}
+
+void Logger::appendRecord(const LogEntry &entry) {
+    const LogSink sink = categorySink(entry.category);
+    QByteArray &buf = m_sinks[sink].buffer;
+    if (m_binaryActive) {
+        m_scratch.resize(0);
+        entry.appendText(m_scratch);
+        zdflog::appendEntry(buf, quint8(entry.level), quint16(entry.category + 1),
+                            quint64(entry.timestampUs), m_scratch);
+    } else {
+        buf.append(wallClockStamp(entry.timestampUs));
+        buf.append(" | ", 3);
+        buf.append(categoryName(entry.category));
+        buf.append(" | ", 3);
+        entry.appendText(buf);
+        buf.append(LINE_END, int(sizeof(LINE_END)) - 1);
+    }
+    if (buf.size() >= SINK_BUFFER_BYTES) writeSink(sink);
+}
+
+void Logger::flushSinks() {
+    for (int i = 0; i < SinkCount; ++i) writeSink(LogSink(i));
+}
+
+void Logger::writeSink(LogSink sink) {
+    SinkState &state = m_sinks[sink];
+    if (state.buffer.isEmpty()) return;
+
+    if (!ensureWriter(sink)) { state.buffer.resize(0); return; }
+
+    bool ok = state.writer->prepare(state.buffer.size(), m_maxFileBytes.load(), m_maxBackups.load());
+    if (ok && m_binaryActive && state.writer->fresh) {
+        // 新文件先写会话记录和完整分类表，分类 id 即枚举值 + 1
+        QByteArray header;
+        zdflog::appendSession(header, m_wallClockBaseMs);
+        for (int c = 0; c < CatCount; ++c)
+            zdflog::appendCategory(header, quint16(c + 1), QByteArray(categoryName(LogCategory(c))));
+        ok = state.writer->write(header);
+    }
+    if (ok) state.writer->fresh = false;
+    if (ok && state.writer->write(state.buffer)) {
+        m_bytesWritten.fetch_add(quint64(state.buffer.size()), std::memory_order_relaxed);
+    } else {
+        // 写失败（如日志目录被删除）时丢弃写入器，下一批重新建目录并打开
+        delete state.writer;
+        state.writer = nullptr;
+    }
+    state.buffer.resize(0);
+}
+
+LogFileWriter *Logger::ensureWriter(LogSink sink) {
+    SinkState &state = m_sinks[sink];
+    if (!state.writer) {
+        if (!ensureLogDirectoryExists()) return nullptr;
+        QString name = QString::fromLatin1(sinkFileName(sink));
+        if (m_binaryActive) {
+            name.chop(4);   // ".log"
+            name += QLatin1String(zdflog::BINARY_SUFFIX);
+        }
+        state.writer = new LogFileWriter(m_logDir + "/" + name);
+    }
+    return state.writer;
+}
+
+// 只打开已存在的日志文件（超限的先轮转）；尚未产生的日志文件仍在首次写入时创建
+void Logger::prepareFiles() {
+    if (!ensureLogDirectoryExists()) return;
+    for (int i = 0; i < SinkCount; ++i) {
+        LogFileWriter *writer = ensureWriter(LogSink(i));
+        if (writer && QFileInfo::exists(writer->path()))
+            writer->prepare(0, m_maxFileBytes.load(), m_maxBackups.load());
+    }
+}
+
+const QByteArray &Logger::wallClockStamp(qint64 timestampUs) {
+    const qint64 second = (m_wallClockBaseMs + timestampUs / 1000) / 1000;
+    if (second != m_cachedStampSecond) {
+        m_cachedStampSecond = second;
+        m_cachedStamp = QDateTime::fromMSecsSinceEpoch(second * 1000).toString("yyyy-MM-dd hh:mm:ss").toUtf8();
+    }
+    return m_cachedStamp;
+}
+
+void Logger::closeFileWriters() {
+    for (SinkState &sink : m_sinks) {
+        delete sink.writer;
+        sink.writer = nullptr;
+    }
+}
+
+void Logger::showMessage(QWidget *p,const QString&t,const QString&m){QMessageBox::warning(p,t,m);}
+
+bool Logger::getPassword(QWidget* p,const QString&t,const QString&l,QString&pwd){
+    bool ok; pwd=QInputDialog::getText(p,t,l,QLineEdit::Password,"",&ok); return ok;
+}
+
+void Logger::shutdown(int drainTimeoutMs) {
+    if (m_shutdownDone.exchange(true)) return;
+
+    // 先写截止时间再置停止位，写线程读到停止位时一定能看到截止时间
+    const qint64 deadline = QDateTime::currentMSecsSinceEpoch() + drainTimeoutMs;
+    m_drainDeadlineMs.store(deadline);
+    m_stopRequested.store(true);
+    {
+        QMutexLocker locker(&m_wakeMutex);
+        m_wakeCond.wakeAll();
+    }
+
+    if (!m_writer->wait(drainTimeoutMs)) {
+        // 磁盘过慢：不再等待，写线程对象故意不释放，避免销毁运行中的线程
+        qWarning() << "日志写线程未在" << drainTimeoutMs << "毫秒内结束，跳过剩余日志";
+        m_writer = nullptr;
+        return;
+    }
+    delete m_writer;
+    m_writer = nullptr;
+
+    // 写线程已退出：之后的日志由调用线程同步写入
+    m_writerStopped.store(true);
+    QMutexLocker locker(&m_directMutex);
+    drainQueue(deadline);
+    // 队列已全部落盘才标记正常退出；写线程超时的情况留给下次启动恢复
+    if (CrashRing *ring = m_crashRing.load()) ring->markClean();
+}
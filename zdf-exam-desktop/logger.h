@@ -0,0 +1,301 @@
+#ifndef ZDF_LOGGER_H
+#define ZDF_LOGGER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <memory>
+#include <set>
+#include <cstddef>
+#include <cstdint>
+
+class QWidget;
+class QThread;
+class LogFileWriter;
+class CrashRing;
+
+// --------------------------- 日志相关 ---------------------------
+enum LogLevel { L_DEBUG, L_INFO, L_WARNING, L_ERROR };
+
+// 日志文件（输出目标），取值即数组下标
+enum LogSink : quint8 { SinkApp, SinkConfig, SinkExit, SinkStartup, SinkCount };
+
+// 日志分类：固定枚举，名称与所属文件见 logger.cpp 中的分类表
+enum LogCategory : quint8 { CatApp, CatConfig, CatHotkey, CatStartup, CatLogger, CatKeys, CatStage, CatNet, CatCount };
+
+// 编译期最低日志级别：低于该级别的 ZDF_LOG_* 调用连同参数求值一起被编译器删除
+// Release 构建默认去掉 DEBUG，可通过 -DZDF_LOG_MIN_LEVEL=0 保留
+#ifndef ZDF_LOG_MIN_LEVEL
+#  ifdef QT_NO_DEBUG
+#    define ZDF_LOG_MIN_LEVEL 1
+#  else
+#    define ZDF_LOG_MIN_LEVEL 0
+#  endif
+#endif
+
+// 延迟格式化的参数：入队时只保存原始值（QString 仅增加引用计数），写线程落盘时再格式化
+struct LogArg {
+    enum Type : quint8 { Int, UInt, Double, Str };
+    LogArg() : type(Int), i(0) {}
+    LogArg(int v) : type(Int), i(v) {}
+    LogArg(long v) : type(Int), i(v) {}
+    LogArg(long long v) : type(Int), i(v) {}
+    LogArg(unsigned v) : type(UInt), u(v) {}
+    LogArg(unsigned long v) : type(UInt), u(v) {}
+    LogArg(unsigned long long v) : type(UInt), u(v) {}
+    LogArg(double v) : type(Double), d(v) {}
+    LogArg(bool v) : type(Str), i(0), s(v ? QStringLiteral("是") : QStringLiteral("否")) {}
+    LogArg(const QString &v) : type(Str), i(0), s(v) {}
+    LogArg(const char *v) : type(Str), i(0), s(QString::fromUtf8(v)) {}
+
+    Type type;
+    union { qint64 i; quint64 u; double d; };
+    QString s;
+};
+
+// 队列槽位。整个环形队列在启动时一次性分配，每个槽位自带固定大小的消息区，
+// 相当于按槽位切分的 arena：稳态下入队不做任何堆分配，槽位出队后原地复用。
+struct LogEntry {
+    static const int MAX_ARGS = 4;
+    static const int INLINE_BYTES = 200;
+    static const quint16 OVERFLOW_LENGTH = 0xFFFF;
+
+    qint64 timestampUs;     // 相对日志会话起点的单调时钟微秒
+    LogLevel level;
+    LogCategory category;
+    quint16 length;         // text 中的 UTF-8 字节数；OVERFLOW_LENGTH 表示消息在 overflow 中
+    const char *format;     // 静态存储期的 UTF-8 格式串（%1..%4），非空时由写线程格式化
+    int argCount;
+    LogArg args[MAX_ARGS];
+    char text[INLINE_BYTES];
+    QByteArray overflow;    // 仅超长消息使用
+    quint64 crashSeq;       // 在崩溃保护环中的序号，0 表示未写入
+
+    // 把消息（或按格式串展开后的消息）以 UTF-8 追加到 out，不产生临时 QString
+    void appendText(QByteArray &out) const;
+};
+
+// 有界无锁多生产者单消费者环形队列（Vyukov 序号算法）
+// 生产者（任意线程）只做一次 CAS，然后在槽位上原地填充；消费者（写日志线程）独占出队
+template<typename T>
+class MpscRing {
+public:
+    explicit MpscRing(size_t capacity) : m_mask(capacity - 1), m_cells(new Cell[capacity]) {
+        Q_ASSERT(capacity >= 2 && (capacity & (capacity - 1)) == 0);
+        for (size_t i = 0; i < capacity; ++i) m_cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    template<typename Fill>
+    bool tryPush(Fill &&fill) {
+        Cell *cell;
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+            if (dif == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (dif < 0) {
+                return false; // 队列已满
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        fill(cell->data);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 仅允许单一消费者线程调用；consume 返回后槽位交还给生产者
+    template<typename Consume>
+    bool tryPop(Consume &&consume) {
+        Cell &cell = m_cells[m_dequeuePos & m_mask];
+        size_t seq = cell.seq.load(std::memory_order_acquire);
+        if ((intptr_t)seq - (intptr_t)(m_dequeuePos + 1) < 0) return false;
+        consume(cell.data);
+        cell.seq.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+        ++m_dequeuePos;
+        return true;
+    }
+
+    size_t capacity() const { return m_mask + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> seq;
+        T data;
+    };
+    const size_t m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+    alignas(64) std::atomic<size_t> m_enqueuePos{0};
+    alignas(64) size_t m_dequeuePos{0};
+};
+
+class Logger {
+public:
+    static Logger& instance() {
+        static Logger logger;
+        return logger;
+    }
+
+    void setLogLevel(LogLevel level) { m_logLevel.store(level, std::memory_order_relaxed); }
+    LogLevel getLogLevel() const { return m_logLevel.load(std::memory_order_relaxed); }
+    bool isEnabled(LogLevel level) const { return level >= m_logLevel.load(std::memory_order_relaxed); }
+
+    bool ensureLogDirectoryExists();
+    QString logDirectory() const { return m_logDir; }
+
+    // 在写日志线程中建日志目录，并提前打开已有的日志文件、轮转上次运行留下的超限文件，
+    // 启动时不占用界面线程
+    void prepareFilesInBackground();
+
+    // 任意线程可调用：只入队，不做文件 I/O
+    void logEvent(LogCategory category, const QString &message, LogLevel level = L_INFO);
+
+    // 延迟格式化入口，一般通过 ZDF_LOG_* 宏调用：级别检查在宏里完成，这里不再重复
+    template<typename... Args>
+    void logDeferred(LogCategory category, LogLevel level, const char *format, const Args&... args) {
+        static_assert(sizeof...(Args) <= LogEntry::MAX_ARGS, "日志参数最多4个");
+        const LogArg captured[] = {LogArg(), LogArg(args)...};
+        enqueue(category, level, nullptr, format, captured + 1, int(sizeof...(Args)));
+    }
+
+    // 唤醒写日志线程立即落盘（不阻塞调用方）
+    void flushAllLogBuffers();
+
+    // 二进制格式：写入 xxx.zlog 紧凑记录，由 zdf-logdump 离线还原为文本；默认仍为文本格式
+    void setBinaryFormat(bool enabled) { m_binaryFormat.store(enabled); }
+    bool isBinaryFormat() const { return m_binaryFormat.load(); }
+
+    // 单个日志文件超过 maxFileBytes 时轮转为 xxx.log.1 ... xxx.log.N，只保留 maxBackups 个历史文件
+    void setRotationPolicy(qint64 maxFileBytes, int maxBackups);
+
+    // 崩溃保护环：每条日志入队时同时写入 log/crash.ring 的内存映射区，进程崩溃后由操作系统保留。
+    // 映射文件和恢复上次异常退出遗留的条目都交给写日志线程完成，调用方不等待
+    void enableCrashRingInBackground(qint64 sizeBytes);
+
+    // 超出槽位内联消息区、不得不在堆上保存的消息条数
+    quint64 overflowCount() const { return m_overflowed.load(); }
+
+    // 累计统计（基准测试与诊断用）：已写入文件的条数和字节数、因队列满丢弃的条数
+    quint64 entriesWritten() const { return m_entriesWritten.load(); }
+    quint64 bytesWritten() const { return m_bytesWritten.load(); }
+    quint64 droppedCount() const { return m_droppedTotal.load(); }
+
+    static const char *categoryName(LogCategory category);
+    static LogSink categorySink(LogCategory category);
+    static const char *sinkFileName(LogSink sink);
+
+    void appEvent(const QString &msg, LogLevel lv=L_INFO) { logEvent(CatApp, msg, lv); }
+    void configEvent(const QString &msg, LogLevel lv=L_INFO) { logEvent(CatConfig, msg, lv); }
+    void hotkeyEvent(const QString &msg) { logEvent(CatHotkey, msg, L_INFO); }
+    void logStartup(const QString &path) { logEvent(CatStartup, QString("程序启动成功，使用配置文件: %1").arg(path), L_INFO); }
+
+    void showMessage(QWidget *p,const QString&t,const QString&m);
+    bool getPassword(QWidget* p,const QString&t,const QString&l,QString&pwd);
+
+    // 停止写日志线程；最多等待 drainTimeoutMs 毫秒把队列写完，超时则放弃剩余条目
+    void shutdown(int drainTimeoutMs = SHUTDOWN_DRAIN_TIMEOUT_MS);
+
+private:
+    friend class LogWriterThread;
+
+    // 每个日志文件一份的写出状态：常驻写入器 + 复用的批量缓冲
+    struct SinkState {
+        LogFileWriter *writer = nullptr;
+        QByteArray buffer;
+    };
+
+    Logger();
+    Logger(const Logger&)=delete; Logger& operator=(const Logger&)=delete;
+    ~Logger();
+
+    void enqueue(LogCategory category, LogLevel level, const QString *message,
+                 const char *format, const LogArg *args, int argCount);
+    void writerLoop();
+    bool drainQueue(qint64 deadlineMs);
+    void appendRecord(const LogEntry &entry);
+    void flushSinks();
+    void writeSink(LogSink sink);
+    LogFileWriter *ensureWriter(LogSink sink);
+    void prepareFiles();
+    void closeFileWriters();
+    // 仅写日志线程调用：恢复的条目不经过队列（可能多于队列容量），按原级别和原时间直接写入
+    // 对应日志文件，返回写入条数
+    int enableCrashRing(qint64 sizeBytes);
+    void noteCrashSeqConsumed(quint64 seq);
+    void markCrashRingPersisted();
+    void wakeWriter();
+    const QByteArray &wallClockStamp(qint64 timestampUs);
+
+    static const int LOG_QUEUE_CAPACITY = 4096;      // 必须是 2 的幂
+    static const int LOG_BATCH_SIZE = 10;            // 积累到该条数即唤醒写线程
+    static const int LOG_FLUSH_INTERVAL_MS = 1000;   // 写线程空闲时的最长落盘间隔
+    static const int SINK_BUFFER_BYTES = 64 * 1024;  // 每个文件的批量缓冲，写满即先落盘
+    static const int FULL_QUEUE_SPIN = 64;           // 队列满时 WARNING/ERROR 的重试次数
+    static const int SHUTDOWN_DRAIN_TIMEOUT_MS = 2000;
+    static const qint64 DEFAULT_MAX_FILE_BYTES = 10 * 1024 * 1024;
+    static const int DEFAULT_MAX_BACKUPS = 5;
+
+    MpscRing<LogEntry> m_queue;
+    std::atomic<LogLevel> m_logLevel;
+    QString m_logDir;
+    QElapsedTimer m_clock;          // 单调时钟，入队时只取一次计数
+    qint64 m_wallClockBaseMs{0};    // m_clock 起点对应的墙钟时间
+
+    // 以下成员仅由当前消费者线程访问
+    SinkState m_sinks[SinkCount];
+    QByteArray m_scratch;           // 二进制格式下展开消息的复用缓冲
+    qint64 m_cachedStampSecond{-1}; // 文本格式时间戳按秒缓存
+    QByteArray m_cachedStamp;
+    bool m_binaryActive{false};     // 当前批次使用的格式
+    // 崩溃保护环序号在生产者领取队列槽位之后才分配，出队顺序与序号顺序不一定一致：
+    // 只把连续出队的最大序号记为已持久化，先于空缺出队的序号暂存在 m_crashSeqAhead
+    quint64 m_crashSeqConsumed{0};
+    std::set<quint64> m_crashSeqAhead;
+
+    std::atomic<bool> m_binaryFormat{false};
+    std::atomic<qint64> m_maxFileBytes{DEFAULT_MAX_FILE_BYTES};
+    std::atomic<int> m_maxBackups{DEFAULT_MAX_BACKUPS};
+
+    QThread *m_writer{};
+    QMutex m_wakeMutex;
+    QWaitCondition m_wakeCond;
+    std::atomic<int> m_pending{0};
+    std::atomic<bool> m_flushRequested{false};
+    std::atomic<bool> m_prepareRequested{false};
+    std::atomic<qint64> m_crashRingRequested{0};
+    std::atomic<bool> m_writerSleeping{false};
+    std::atomic<bool> m_stopRequested{false};
+    std::atomic<qint64> m_drainDeadlineMs{0};
+    std::atomic<quint64> m_dropped{0};
+    std::atomic<quint64> m_overflowed{0};
+    std::atomic<quint64> m_droppedTotal{0};
+    std::atomic<quint64> m_entriesWritten{0};
+    std::atomic<quint64> m_bytesWritten{0};
+    std::atomic<CrashRing*> m_crashRing{nullptr};
+    std::atomic<bool> m_writerStopped{false};
+    std::atomic<bool> m_shutdownDone{false};     // 调用线程置位，写线程在 enableCrashRing 中读取
+    QMutex m_directMutex;   // 写线程退出后，由持有该锁的调用线程同步出队写入
+};
+
+// 先判断级别再求值参数：被过滤的调用只有一次原子读和比较，不构造任何 QString
+#define ZDF_LOG_ENABLED(level) \
+    ((level) >= ZDF_LOG_MIN_LEVEL && Logger::instance().isEnabled(level))
+
+#define ZDF_LOG_EVENT(category, level, format, ...) \
+    do { \
+        if (ZDF_LOG_ENABLED(level)) \
+            Logger::instance().logDeferred(category, level, "" format "", ##__VA_ARGS__); \
+    } while (0)
+
+#define ZDF_LOG_APP(level, format, ...)    ZDF_LOG_EVENT(CatApp, level, format, ##__VA_ARGS__)
+#define ZDF_LOG_CONFIG(level, format, ...) ZDF_LOG_EVENT(CatConfig, level, format, ##__VA_ARGS__)
+#define ZDF_LOG_HOTKEY(format, ...)        ZDF_LOG_EVENT(CatHotkey, L_INFO, format, ##__VA_ARGS__)
+#define ZDF_LOG_KEYS(level, format, ...)   ZDF_LOG_EVENT(CatKeys, level, format, ##__VA_ARGS__)
+
+#endif // ZDF_LOGGER_H
@@ -24,6 +24,27 @@
 #include <QWindowStateChangeEvent>
 #include <QShortcut>
 #include <QSysInfo>
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
+#include <QStringList>
+#include <QChildEvent>
+#include <QSplashScreen>
+#include <QPainter>
+#include <QScreen>
+
+#include <cstring>
+
+#include "logger.h"
+#include "config.h"
+#include "sysinfo.h"
+#include "profile.h"
+#include "timeline.h"
+#include "httpcache.h"
+#include "assetpack.h"
+#include "urlfilter.h"
+#include "reqtiming.h"
+#include "peershare.h"
+#include "stager.h"
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -32,349 +53,232 @@
 #include <fcntl.h>
 #endif
 
-// --------------------------- 系统信息检测结构体 ---------------------------
-struct SystemInfo {
-    bool isOldWin = false;
-    bool lowMemory = false;
-    bool isOldCpu = false;
-    bool isVirtualized = false;
-    QString cpuInfo = "Unknown";
-#ifdef Q_OS_WIN
-    DWORDLONG totalMemoryMB = 0;
-#else
-    quint64 totalMemoryMB = 0;
-#endif
-};
-
-SystemInfo detectSystemInfo() {
-    SystemInfo info;
-    
-#ifdef Q_OS_WIN
-    // 检测Windows版本
-    QString winVer = QSysInfo::productVersion();
-    info.isOldWin = winVer.startsWith("6.0") || winVer.startsWith("6.1") || winVer.startsWith("5.");
-    
-    if(info.isOldWin) {
-        // 检测内存
-        MEMORYSTATUSEX memStatus;
-        memStatus.dwLength = sizeof(memStatus);
-        GlobalMemoryStatusEx(&memStatus);
-        info.totalMemoryMB = memStatus.ullTotalPhys / (1024 * 1024);
-        info.lowMemory = info.totalMemoryMB <= 4096;
-        
-        // 检测CPU信息（只执行一次）
-        HKEY hKey;
-        if (RegOpenKeyExA(HKEY_LOCAL_MACHINE, 
-                          "HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0", 
-                          0, KEY_READ, &hKey) == ERROR_SUCCESS) {
-            DWORD dataSize = 256;
-            char data[256];
-            if (RegQueryValueExA(hKey, "ProcessorNameString", NULL, NULL, 
-                                (LPBYTE)data, &dataSize) == ERROR_SUCCESS) {
-                info.cpuInfo = QString::fromLocal8Bit(data).trimmed();
-            }
-            RegCloseKey(hKey);
-        }
-        
-        // 检测是否为老旧CPU架构
-        QRegExp oldCpuPattern("\\b[iI][3-7]-[2-4]\\d{3}\\b");
-        if (info.cpuInfo.contains(oldCpuPattern) || 
-            info.cpuInfo.contains("Haswell", Qt::CaseInsensitive) ||
-            info.cpuInfo.contains("Ivy Bridge", Qt::CaseInsensitive) ||
-            info.cpuInfo.contains("Sandy Bridge", Qt::CaseInsensitive)) {
-            info.isOldCpu = true;
-        }
-        
-        // 检测是否为虚拟化环境
-        if (info.cpuInfo.contains("Virtual", Qt::CaseInsensitive) ||
-            info.cpuInfo.contains("QEMU", Qt::CaseInsensitive) ||
-            info.cpuInfo.contains("VMware", Qt::CaseInsensitive) ||
-            info.cpuInfo.contains("VirtualBox", Qt::CaseInsensitive)) {
-            info.isVirtualized = true;
-        }
-    }
-#endif
-    
-    return info;
-}
-
-// --------------------------- 日志相关 ---------------------------
-enum LogLevel { L_DEBUG, L_INFO, L_WARNING, L_ERROR };
-
-struct LogEntry {
-    QDateTime timestamp;
-    QString category;
-    QString message;
-    QString filename;
-};
-
-class Logger {
+// --------------------------- 按键统计 ---------------------------
+// 普通按键只在固定大小的计数表里累加（按键类别 × 修饰键组合，外加每分钟总数），
+// 每个统计周期输出一条汇总；被拦截或可疑的组合键仍逐条记录。
+class KeystrokeStats {
 public:
-    static Logger& instance() {
-        static Logger logger;
-        return logger;
-    }
+    enum KeyClass { KeyLetter, KeyDigit, KeySymbol, KeyWhitespace, KeyEdit, KeyNavigation,
+                    KeyFunction, KeyEscape, KeyModifier, KeyOther, KeyClassCount };
+    static const int MODIFIER_COMBOS = 16;      // Shift/Ctrl/Alt/Meta 四位组合
+    static const int MAX_SUMMARY_MINUTES = 60;
 
-    void setLogLevel(LogLevel level) { m_logLevel = level; }
-    LogLevel getLogLevel() const { return m_logLevel; }
+    static KeystrokeStats& instance(){ static KeystrokeStats ks; return ks; }
 
-    bool ensureLogDirectoryExists() {
-        QString logDir = QCoreApplication::applicationDirPath() + "/log";
-        QDir dir(logDir);
-        if (!dir.exists())
-            return dir.mkpath(".");
-        return true;
+    void configure(int summaryMinutes, bool logEveryKey) {
+        flush();
+        m_summaryMinutes = qBound(1, summaryMinutes, MAX_SUMMARY_MINUTES);
+        m_logEveryKey = logEveryKey;
     }
 
-    void logEvent(const QString &category, const QString &message,
-                  const QString &filename = "app.log", LogLevel level = L_INFO) {
-        if (level < m_logLevel) return;
+    // 正常送达页面的按键
+    void record(const QKeyEvent *e) {
+        if (m_logEveryKey) ZDF_LOG_KEYS(L_INFO, "按键事件: %1", QKeySequence(e->key()|e->modifiers()).toString());
+        tick();
+        const KeyClass cls = classify(e->key());
+        const int mods = modifierIndex(e->modifiers());
+        ++m_counts[cls][mods];
+        ++m_minuteTotals[m_currentMinute - m_periodStartMinute];
+        ++m_total;
+        if (isSuspicious(cls, mods)) ++m_suspicious;
+        if (isSuspicious(cls, mods) && !e->isAutoRepeat())
+            ZDF_LOG_KEYS(L_WARNING, "可疑按键: %1", QKeySequence(e->key()|e->modifiers()).toString());
+    }
 
-        LogEntry entry{QDateTime::currentDateTime(), category, message, filename};
-        m_logBuffer[filename].append(entry);
-        if (m_logBuffer[filename].size() >= LOG_BUFFER_SIZE || level >= L_WARNING)
-            flushLogBuffer(filename);
+    // 被事件过滤器拦截的组合键，逐条记录（按住不放的自动重复只计数）
+    void recordBlocked(const QKeyEvent *e) {
+        tick();
+        ++m_blocked;
+        if (!e->isAutoRepeat())
+            ZDF_LOG_KEYS(L_WARNING, "拦截按键: %1", QKeySequence(e->key()|e->modifiers()).toString());
     }
 
-    void flushLogBuffer(const QString &filename) {
-        if (m_logBuffer[filename].isEmpty()) return;
-        if (!ensureLogDirectoryExists()) return;
-
-        QString logPath = QCoreApplication::applicationDirPath() + "/log/" + filename;
-        QFile file(logPath);
-        if (file.open(QIODevice::Append | QIODevice::Text)) {
-            QTextStream out(&file);
-            out.setCodec("UTF-8");
-            for (const LogEntry &e : std::as_const(m_logBuffer[filename])) {
-                out << e.timestamp.toString("yyyy-MM-dd hh:mm:ss")
-                    << " | " << e.category << " | " << e.message << "\n";
-            }
-            file.close();
-            m_logBuffer[filename].clear();
+    // 跨过统计周期时输出汇总；由按键和维护定时器驱动
+    void tick() {
+        const qint64 minute = m_clock.elapsed() / 60000;
+        if (minute == m_currentMinute) return;
+        if (minute - m_periodStartMinute >= m_summaryMinutes) {
+            flush();
+            return;
         }
+        m_currentMinute = minute;
     }
 
-    void flushAllLogBuffers() {
-        const QStringList keys = m_logBuffer.keys();
-        for (const QString &k : keys) flushLogBuffer(k);
+    // 立即输出当前周期的汇总（退出前调用）
+    void flush() {
+        if (m_total > 0 || m_blocked > 0) emitSummary();
+        memset(m_counts, 0, sizeof(m_counts));
+        memset(m_minuteTotals, 0, sizeof(m_minuteTotals));
+        m_total = m_blocked = m_suspicious = 0;
+        m_periodStartMinute = m_currentMinute = m_clock.elapsed() / 60000;
     }
 
-    void appEvent(const QString &msg, LogLevel lv=L_INFO) { logEvent("应用程序", msg, "app.log", lv); }
-    void configEvent(const QString &msg, LogLevel lv=L_INFO) { logEvent("配置文件", msg, "config.log", lv); }
-    void hotkeyEvent(const QString &msg) { logEvent("热键退出尝试", msg, "exit.log", L_INFO); }
-    void logStartup(const QString &path) { logEvent("启动", QString("程序启动成功，使用配置文件: %1").arg(path), "startup.log", L_INFO); }
+private:
+    KeystrokeStats() { m_clock.start(); }
+
+    static KeyClass classify(int key) {
+        if (key >= Qt::Key_A && key <= Qt::Key_Z) return KeyLetter;
+        if (key >= Qt::Key_0 && key <= Qt::Key_9) return KeyDigit;
+        if (key == Qt::Key_Space || key == Qt::Key_Return || key == Qt::Key_Enter || key == Qt::Key_Tab) return KeyWhitespace;
+        if (key == Qt::Key_Backspace || key == Qt::Key_Delete || key == Qt::Key_Insert) return KeyEdit;
+        if (key >= Qt::Key_Home && key <= Qt::Key_PageDown) return KeyNavigation;
+        if (key >= Qt::Key_F1 && key <= Qt::Key_F35) return KeyFunction;
+        if (key == Qt::Key_Escape) return KeyEscape;
+        if ((key >= Qt::Key_Shift && key <= Qt::Key_ScrollLock) || key == Qt::Key_AltGr) return KeyModifier;
+        if (key > 0 && key < 0x01000000) return KeySymbol;
+        return KeyOther;
+    }
 
-    void showMessage(QWidget *p,const QString&t,const QString&m){QMessageBox::warning(p,t,m);}
-    bool getPassword(QWidget* p,const QString&t,const QString&l,QString&pwd){
-        bool ok; pwd=QInputDialog::getText(p,t,l,QLineEdit::Password,"",&ok); return ok;
+    static int modifierIndex(Qt::KeyboardModifiers m) {
+        return ((m & Qt::ShiftModifier) ? 1 : 0) | ((m & Qt::ControlModifier) ? 2 : 0)
+             | ((m & Qt::AltModifier) ? 4 : 0) | ((m & Qt::MetaModifier) ? 8 : 0);
     }
 
-    void shutdown() {
-        flushAllLogBuffers();
-        if (m_flushTimer) { m_flushTimer->stop(); delete m_flushTimer; m_flushTimer=nullptr; }
+    // 带 Ctrl/Alt/Meta 仍送达页面的按键、功能键和 Esc 视为可疑
+    static bool isSuspicious(KeyClass cls, int mods) {
+        return (mods & ~1) != 0 || cls == KeyFunction || cls == KeyEscape;
     }
 
-private:
-    Logger():m_logLevel(L_INFO) {
-        QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
-        m_flushTimer=new QTimer();
-        QObject::connect(m_flushTimer,&QTimer::timeout,[this](){flushAllLogBuffers();});
-        
-        // 使用默认定时器频率，避免构造函数中的复杂检测
-        m_flushTimer->start(60000); // 默认1分钟间隔
+    void emitSummary() {
+        static const char *const classNames[KeyClassCount] = {
+            "字母", "数字", "符号", "空白", "编辑", "导航", "功能键", "Esc", "修饰键", "其他"};
+        static const char *const modNames[] = {"Shift+", "Ctrl+", "Alt+", "Meta+"};
+
+        QStringList perMinute;
+        const int minutes = int(qMin<qint64>(m_currentMinute - m_periodStartMinute + 1, m_summaryMinutes));
+        for (int i = 0; i < minutes; ++i) perMinute << QString::number(m_minuteTotals[i]);
+
+        QStringList cells;
+        for (int c = 0; c < KeyClassCount; ++c) {
+            for (int m = 0; m < MODIFIER_COMBOS; ++m) {
+                if (!m_counts[c][m]) continue;
+                QString prefix;
+                for (int bit = 0; bit < 4; ++bit) if (m & (1 << bit)) prefix += modNames[bit];
+                cells << QString("%1%2 %3").arg(prefix, QString::fromUtf8(classNames[c])).arg(m_counts[c][m]);
+            }
+        }
+        Logger::instance().logEvent(CatKeys,
+            QString("按键统计（%1分钟）：共%2次，每分钟[%3]，可疑%4次，拦截%5次；%6")
+                .arg(minutes).arg(m_total).arg(perMinute.join(",")).arg(m_suspicious).arg(m_blocked)
+                .arg(cells.join("，")));
     }
-    Logger(const Logger&)=delete; Logger& operator=(const Logger&)=delete;
-    ~Logger(){shutdown();}
-    static const int LOG_BUFFER_SIZE = 10;
-    QMap<QString,QList<LogEntry>> m_logBuffer;
-    LogLevel m_logLevel;
-    QTimer* m_flushTimer{};
-};
 
+    QElapsedTimer m_clock;
+    int m_summaryMinutes{5};
+    bool m_logEveryKey{false};
+    qint64 m_periodStartMinute{0};
+    qint64 m_currentMinute{0};
+    quint32 m_counts[KeyClassCount][MODIFIER_COMBOS] = {};
+    quint32 m_minuteTotals[MAX_SUMMARY_MINUTES] = {};
+    quint32 m_total{0}, m_blocked{0}, m_suspicious{0};
+};
 
-// --------------------------- 配置管理 ---------------------------
-class ConfigManager {
+// --------------------------- 启动画面 ---------------------------
+// QApplication 创建后立即显示的原生全屏启动画面，不依赖 WebEngine：浏览器在其下方照常加载，
+// 考试页面首次绘制后再撤下。画面是一次性绘制的静态图，只在状态文字变化时重绘
+class StartupSplash : public QSplashScreen {
 public:
-    static ConfigManager& instance(){static ConfigManager cm; return cm;}
-
-    bool loadConfig(const QString &configPath="resources/config.json"){
-        QString exe = QCoreApplication::applicationDirPath();
-        QStringList paths{
-            exe+"/config.json",
-            QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)+"/config.json",
-#ifdef Q_OS_UNIX
-            "/etc/zdf-exam-desktop/config.json",
-#endif
-            exe+"/"+configPath,
-            exe+"/../"+configPath,
-            configPath
-        };
-        if (QDir::isAbsolutePath(configPath)) paths << configPath;
-
-        for (const QString &p: paths){
-            QFile f(p); if(!f.exists()) continue;
-            if(!f.open(QIODevice::ReadOnly)) continue;
-            QJsonParseError e; auto doc=QJsonDocument::fromJson(f.readAll(),&e); f.close();
-            if(doc.isNull()||!doc.isObject()) continue;
-            config=doc.object();
-            if(!validateConfig()) continue;
-            actualConfigPath=p; return true;
-        }
-        return false;
+    StartupSplash() : QSplashScreen(renderBackground(), Qt::WindowStaysOnTopHint | Qt::FramelessWindowHint) {
+        setStatus("正在启动中，请稍候...");
     }
 
-    bool validateConfig() const {
-        for (const QString &k : {"url","exitPassword","appName"})
-            if(!config.contains(k)||config[k].toString().isEmpty()) return false;
-        return true;
-    }
+    void setStatus(const QString &text) { showMessage(text, Qt::AlignHCenter | Qt::AlignTop, Qt::white); }
 
-    QString getUrl()          const { return config.value("url").toString("http://stu.sdzdf.com/"); }
-    QString getExitPassword() const { return config.value("exitPassword").toString("123456"); }
-    QString getAppName()      const { return config.value("appName").toString("zdf-exam-desktop"); }
-    bool    isHardwareAccelerationDisabled() const { return config.value("disableHardwareAcceleration").toBool(false); }
-    QString getActualConfigPath() const { return actualConfigPath; }
-    
-    // 低内存模式相关配置
-    bool isLowMemoryModeEnabled() const {
-        QJsonObject lowMemConfig = config.value("lowMemoryMode").toObject();
-        QString enabled = lowMemConfig.value("enabled").toString("auto");
-        return enabled == "true" || enabled == "auto";
-    }
-    int getLowMemoryThreshold() const {
-        QJsonObject lowMemConfig = config.value("lowMemoryMode").toObject();
-        return lowMemConfig.value("memoryThresholdMB").toInt(4096);
-    }
-    bool isProgressiveLoadingEnabled() const {
-        QJsonObject lowMemConfig = config.value("lowMemoryMode").toObject();
-        return lowMemConfig.value("progressiveLoading").toBool(true);
-    }
-    int getProgressiveLoadingDelay() const {
-        QJsonObject lowMemConfig = config.value("lowMemoryMode").toObject();
-        return lowMemConfig.value("progressiveLoadingDelay").toInt(3000);
+protected:
+    static QPixmap renderBackground() {
+        const QSize size = QGuiApplication::primaryScreen() ? QGuiApplication::primaryScreen()->size() : QSize(1280, 800);
+        QPixmap pixmap(size);
+        pixmap.fill(QColor(0x1a, 0x1a, 0x1a));
+        QPainter painter(&pixmap);
+        painter.setPen(Qt::white);
+        QFont title = painter.font();
+        title.setPixelSize(24);
+        painter.setFont(title);
+        painter.drawText(QRect(0, 0, size.width(), size.height() / 2 - 10), Qt::AlignHCenter | Qt::AlignBottom,
+                         "智多分机考桌面端");
+        return pixmap;
     }
 
-    bool createDefaultConfig(const QString &path){
-        QJsonObject lowMemConfig{
-            {"enabled", "auto"},
-            {"memoryThresholdMB", 4096},
-            {"progressiveLoading", true},
-            {"progressiveLoadingDelay", 3000}
-        };
-        
-        QJsonObject def{{"url","http://stu.sdzdf.com/"},{"exitPassword","sdzdf@2025"},
-                        {"appName","智多分机考桌面端"},{"iconPath","logo.svg"},
-                        {"appVersion","1.0.0"},{"disableHardwareAcceleration",false},
-                        {"lowMemoryMode", lowMemConfig}};
-        QFileInfo fi(path); QDir d=fi.dir(); if(!d.exists()&&!d.mkpath(".")) return false;
-        QFile f(path); if(!f.open(QIODevice::WriteOnly)) return false;
-        f.write(QJsonDocument(def).toJson()); f.close(); return true;
+    // 状态文字画在标题下方
+    void drawContents(QPainter *painter) override {
+        painter->setPen(Qt::white);
+        painter->drawText(rect().adjusted(0, height() / 2 + 20, 0, 0), Qt::AlignHCenter | Qt::AlignTop, message());
     }
 
-    QJsonObject config;
-private:
-    ConfigManager(){ loadConfig(); }
-    QString actualConfigPath;
+    void mousePressEvent(QMouseEvent *) override {}   // 默认点击即关闭，考试终端上不允许
 };
 
 // --------------------------- 浏览器封装 ---------------------------
 class ShellBrowser : public QWebEngineView {
     QHotkey *exitHotkeyF10{}, *exitHotkeyBackslash{};
     QTimer *maintenanceTimer{};
+    int autoMaintenanceInterval{10000};     // 未配置 maintenance.intervalMs 时取性能档案的间隔
     bool needFocusCheck{true}, needFullscreenCheck{true};
+    bool examLoadRequested{false}, examLoadFinished{false}, firstPaintSeen{false}, startupDone{false};
+    StartupSplash *splash{};                // 考试页面首次绘制前覆盖在浏览器上方
+
+    // 渐进式加载的就绪状态：各项的就绪时刻（毫秒，-1 表示尚未就绪），全部就绪或到达上限时打开考试页面
+    struct Readiness {
+        QElapsedTimer clock;
+        qint64 warmupMs{-1}, rendererMs{-1}, memoryMs{-1};
+        int capMs{0};
+        int minFreeMemoryMB{0};
+        QTimer *poll{};
+        QMetaObject::Connection warmupLoaded;
+    } readiness;
 
 public:
-    ShellBrowser() {
-        setWindowTitle(ConfigManager::instance().getAppName());
+    ShellBrowser(const SystemInfo &sysInfo, const PerformanceProfile &profile, StartupSplash *startupSplash)
+        : splash(startupSplash) {
+        setWindowTitle(ConfigManager::instance().snapshot().appName);
         setMinimumSize(1280,800);
 
+        // 各项开关均由性能档案决定，命中的规则已写入 startup.log
         auto *settings = QWebEngineSettings::globalSettings();
         settings->setAttribute(QWebEngineSettings::JavascriptEnabled,true);
         settings->setAttribute(QWebEngineSettings::AutoLoadImages,true);
-        settings->setAttribute(QWebEngineSettings::PluginsEnabled,true);
+        settings->setAttribute(QWebEngineSettings::PluginsEnabled,profile.plugins);
         settings->setAttribute(QWebEngineSettings::LocalStorageEnabled,true);
-        settings->setAttribute(QWebEngineSettings::JavascriptCanOpenWindows,true);
-
-        // 获取系统信息（只检测一次）
-        SystemInfo sysInfo = detectSystemInfo();
-        bool hw = !ConfigManager::instance().isHardwareAccelerationDisabled();
-        
-        if(sysInfo.isOldWin) {
-            hw = false;
-            // Windows 7特殊配置：强制禁用可能导致崩溃的功能
-            settings->setAttribute(QWebEngineSettings::PluginsEnabled,false);
-            settings->setAttribute(QWebEngineSettings::JavascriptCanOpenWindows,false);
-            Logger::instance().appEvent("检测到Windows 7系统，启用兼容模式", L_INFO);
-            
-            if(sysInfo.isVirtualized) {
-                Logger::instance().appEvent(QString("检测到虚拟化环境 - CPU：%1，总内存：%2MB")
-                                          .arg(sysInfo.cpuInfo).arg(sysInfo.totalMemoryMB), L_WARNING);
-            }
-        }
-        settings->setAttribute(QWebEngineSettings::WebGLEnabled,hw);
-        settings->setAttribute(QWebEngineSettings::Accelerated2dCanvasEnabled,hw);
+        settings->setAttribute(QWebEngineSettings::JavascriptCanOpenWindows,profile.javascriptCanOpenWindows);
+        settings->setAttribute(QWebEngineSettings::WebGLEnabled,profile.webgl);
+        settings->setAttribute(QWebEngineSettings::Accelerated2dCanvasEnabled,profile.accelerated2dCanvas);
         
         // Qt 5.9.9中没有这些属性，移除以确保兼容性
         // settings->setAttribute(QWebEngineSettings::ScreenCaptureEnabled,false);
         // settings->setAttribute(QWebEngineSettings::WebRTCPublicInterfacesOnly,true);
-        
-        // Windows 7最兼容设置：基于系统信息禁用硬件加速功能
+
         if(sysInfo.isOldWin) {
-            if(sysInfo.isOldCpu) {
-                Logger::instance().appEvent("检测到Haswell/Ivy Bridge/Sandy Bridge等老旧CPU架构，启用老旧硬件兼容模式", L_WARNING);
-            }
-            
-            if(sysInfo.lowMemory || sysInfo.isOldCpu || sysInfo.isVirtualized) {
-                Logger::instance().appEvent("检测到低内存/老旧CPU/虚拟化环境，已启用超保守优化模式", L_WARNING);
-            }
-            
-            // 强制禁用所有硬件加速功能
-            settings->setAttribute(QWebEngineSettings::WebGLEnabled, false);
-            settings->setAttribute(QWebEngineSettings::Accelerated2dCanvasEnabled, false);
-            settings->setAttribute(QWebEngineSettings::PluginsEnabled, false);
-            hw = false;
+            Logger::instance().appEvent("检测到Windows 7系统，启用兼容模式", L_INFO);
+        }
+#ifdef Q_OS_LINUX
+        ZDF_LOG_APP(L_INFO, "系统信息 - CPU：%1，可用核心：%2，可用内存：%3MB，虚拟化：%4",
+                    sysInfo.cpuInfo, sysInfo.cpuCores, sysInfo.totalMemoryMB,
+                    sysInfo.isVirtualized ? sysInfo.virtualization : QString("否"));
+#endif
+        if(sysInfo.isOldCpu) {
+            ZDF_LOG_APP(L_WARNING, "CPU性能评分偏低（%1分），启用老旧硬件兼容模式", sysInfo.capabilityScore);
         }
 
-        // 基于已检测的系统信息决定启动策略
-        bool useProgressiveLoading = sysInfo.lowMemory || sysInfo.isOldCpu || sysInfo.isVirtualized;
-
-        if(useProgressiveLoading) {
-            // 渐进式启动：先显示加载页面
-            setHtml("<html><head><style>"
-                   "body{background:#1a1a1a;color:#fff;font-family:Arial;text-align:center;padding-top:200px;}"
-                   ".loader{font-size:24px;margin-bottom:20px;}"
-                   ".spinner{border:4px solid #333;border-top:4px solid #fff;border-radius:50%;"
-                   "width:40px;height:40px;animation:spin 1s linear infinite;margin:20px auto;}"
-                   "@keyframes spin{0%{transform:rotate(0deg);} 100%{transform:rotate(360deg);}}"
-                   "</style></head><body>"
-                   "<div class='loader'>智多分机考桌面端</div>"
-                   "<div class='spinner'></div>"
-                   "<div>正在启动中，请稍候...</div>"
-                   "</body></html>");
-            
-            Logger::instance().appEvent("程序启动 - 使用渐进式加载模式", L_INFO);
-            
-            // 延迟加载实际页面，给WebEngine更多初始化时间
-            // 根据系统环境设置不同的延迟时间
-            int delayTime = 3000; // 默认3秒
-            
-            if(sysInfo.isVirtualized && (sysInfo.lowMemory || sysInfo.isOldCpu)) {
-                delayTime = 30000; // 虚拟化+低配置环境：等待30秒
-                Logger::instance().appEvent("检测到虚拟化低配置环境，启用超长延迟启动模式（30秒）", L_WARNING);
-            } else if(sysInfo.lowMemory || sysInfo.isOldCpu) {
-                delayTime = 15000; // 低配置环境：等待15秒
-                Logger::instance().appEvent("检测到低配置环境，启用延迟启动模式（15秒）", L_INFO);
-            } else if(useProgressiveLoading) {
-                delayTime = ConfigManager::instance().getProgressiveLoadingDelay();
+        traceLoadEvents();
+        if(profile.progressiveLoading) {
+            // 渐进式启动：启动画面由原生窗口显示，这里只加载一个不含动画的空白预热页，
+            // 让渲染进程先启动，就绪后再打开实际页面，给WebEngine更多初始化时间
+            StartupTimeline::instance().mark("setHtml");
+            setHtml("<html><body style='background:#1a1a1a'></body></html>");
+
+            if(profile.loadOnReady) {
+                Logger::instance().appEvent("程序启动 - 使用渐进式加载模式", L_INFO);
+                startReadinessWait(profile.loadDelayMs, profile.loadMinFreeMemoryMB);
+            } else {
+                ZDF_LOG_APP(L_INFO, "程序启动 - 使用渐进式加载模式（固定延迟%1秒）", profile.loadDelayMs / 1000.0);
+                QTimer::singleShot(profile.loadDelayMs, this, [this](){
+                    loadExamPage();
+                    Logger::instance().appEvent("延迟加载完成，正在访问考试页面", L_INFO);
+                });
             }
-            
-            QTimer::singleShot(delayTime, this, [this](){
-                load(QUrl(ConfigManager::instance().getUrl()));
-                Logger::instance().appEvent("延迟加载完成，正在访问考试页面", L_INFO);
-            });
         } else {
             // 标准启动
-            load(QUrl(ConfigManager::instance().getUrl()));
+            loadExamPage();
             Logger::instance().appEvent("程序启动");
         }
 
@@ -385,20 +289,30 @@ public:
 
         setWindowFlags(Qt::Window | Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint);
         setWindowState(Qt::WindowFullScreen); showFullScreen();
+        if(splash) { splash->setStatus("正在打开考试页面..."); splash->raise(); }
 
         maintenanceTimer=new QTimer(this);
-        connect(maintenanceTimer,&QTimer::timeout,this,[this, sysInfo](){
-            // 虚拟化环境优化：根据环境调整检查频率
+        const bool monitorMemory = sysInfo.lowMemory;
+        const int focusCheckInterval = profile.focusCheckTicks;
+        const int fullscreenCheckInterval = profile.fullscreenCheckTicks;
+        const int memoryCheckInterval = profile.memoryCheckTicks;
+        connect(maintenanceTimer,&QTimer::timeout,this,
+                [this, monitorMemory, focusCheckInterval, fullscreenCheckInterval, memoryCheckInterval](){
             static int checkCounter = 0;
             checkCounter++;
-            
-            // 根据环境设置检查频率
-            int focusCheckInterval = sysInfo.isVirtualized ? 12 : 6;  // 虚拟化环境：2分钟，其他：1分钟
-            int fullscreenCheckInterval = sysInfo.isVirtualized ? 12 : 6;
-            int memoryCheckInterval = sysInfo.isVirtualized ? 120 : 60; // 虚拟化环境：20分钟，其他：10分钟
+
+            // 按键统计跨周期时输出汇总（长时间无按键也能按时落盘）
+            KeystrokeStats::instance().tick();
+
+            // 页面加载后陆续请求的资源也计入缓存统计和请求计时；被拦截的请求按周期汇总写日志
+            if(checkCounter % STATS_TICKS == 0) {
+                HttpCacheStats::instance().collect(page());
+                RequestTiming::instance().collect(page());
+                BlockedRequestStats::instance().flush();
+            }
             
             // 焦点检查
-            if(needFocusCheck && checkCounter % focusCheckInterval == 1) {
+            if(needFocusCheck && !splash && checkCounter % focusCheckInterval == 1 % focusCheckInterval) {
                 if(!isActiveWindow()){ 
                     raise(); 
                     activateWindow(); 
@@ -406,7 +320,7 @@ public:
             }
             
             // 全屏检查
-            if(needFullscreenCheck && checkCounter % fullscreenCheckInterval == 3) {
+            if(needFullscreenCheck && !splash && checkCounter % fullscreenCheckInterval == 3 % fullscreenCheckInterval) {
                 if(windowState()!=Qt::WindowFullScreen){ 
                     setWindowState(Qt::WindowFullScreen); 
                     showFullScreen(); 
@@ -415,7 +329,7 @@ public:
             
             // 内存监控（仅在低内存环境下启用）
 #ifdef Q_OS_WIN
-            if(sysInfo.lowMemory) {
+            if(monitorMemory) {
                 static int memoryCheckCounter = 0;
                 if(++memoryCheckCounter >= memoryCheckInterval) {
                     memoryCheckCounter = 0;
@@ -426,30 +340,198 @@ public:
                     DWORDLONG availMemoryMB = memStatus.ullAvailPhys / (1024 * 1024);
                     
                     if(availMemoryMB < 200) { // 可用内存少于200MB时触发垃圾回收
-                        Logger::instance().appEvent(QString("检测到内存不足：可用%1MB，触发垃圾回收")
-                                                   .arg(availMemoryMB), L_WARNING);
+                        ZDF_LOG_APP(L_WARNING, "检测到内存不足：可用%1MB，触发垃圾回收", availMemoryMB);
                         
                         this->page()->runJavaScript("if(window.gc) window.gc(); "
                                                    "if(window.CollectGarbage) window.CollectGarbage();");
                     }
                 }
             }
+#else
+            Q_UNUSED(monitorMemory); Q_UNUSED(memoryCheckInterval);
 #endif
         });
         
-        // 根据环境设置维护定时器间隔
-        int maintenanceInterval = sysInfo.isVirtualized ? 20000 : 10000; // 虚拟化环境：20秒，其他：10秒
-        maintenanceTimer->start(maintenanceInterval);
+        // 维护定时器间隔取性能档案，配置文件中指定时以配置为准
+        autoMaintenanceInterval = profile.maintenanceIntervalMs;
+        maintenanceTimer->start(maintenanceIntervalFor(ConfigManager::instance().snapshot()));
 
         setContextMenuPolicy(Qt::NoContextMenu);
 
         auto *refreshShortcut=new QShortcut(QKeySequence("Ctrl+R"),this);
         connect(refreshShortcut,&QShortcut::activated,this,[this](){ reload(); Logger::instance().appEvent("用户使用Ctrl+R刷新页面"); });
+
+        // 监考老师在学生反映卡顿时导出请求计时，文件写到日志目录
+        auto *timingShortcut=new QShortcut(QKeySequence("Ctrl+Shift+H"),this);
+        connect(timingShortcut,&QShortcut::activated,this,[this](){
+            RequestTiming::instance().collect(page(), [](){
+                RequestTiming::instance().logSummary(CatNet, "网络耗时");
+                RequestTiming::instance().exportHar("快捷键导出");
+            });
+        });
+    }
+
+    // 配置热更新：只处理与浏览器相关、可以在运行中生效的字段，返回已应用的字段名
+    QStringList applyConfig(const AppConfig &old, const AppConfig &now) {
+        QStringList applied;
+        if (now.appName != old.appName) {
+            setWindowTitle(now.appName);
+            applied << "appName";
+        }
+        if (maintenanceIntervalFor(now) != maintenanceIntervalFor(old)) {
+            maintenanceTimer->setInterval(maintenanceIntervalFor(now));
+            applied << "maintenance.intervalMs";
+        }
+        if (now.url != old.url) {
+            load(QUrl(now.url));
+            applied << "url";
+        }
+        return applied;
     }
 
 protected:
+    static const int READINESS_POLL_MS = 200;
+    static const int STATS_TICKS = 6;           // 每 N 次维护定时器触发取回缓存命中计数和请求计时、写出拦截汇总
+
+    void startReadinessWait(int capMs, int minFreeMemoryMB) {
+        readiness.clock.start();
+        readiness.capMs = capMs;
+        readiness.minFreeMemoryMB = minFreeMemoryMB;
+
+        // 预热页完成说明渲染进程已启动；再执行一次脚本往返，确认渲染进程已空闲、能响应
+        readiness.warmupLoaded = connect(this, &QWebEngineView::loadFinished, this, [this](bool){
+            disconnect(readiness.warmupLoaded);
+            readiness.warmupMs = readiness.clock.elapsed();
+            page()->runJavaScript("document.readyState", [this](const QVariant &){
+                if(readiness.rendererMs >= 0 || !readiness.poll) return;
+                readiness.rendererMs = readiness.clock.elapsed();
+                checkReadiness();
+            });
+        });
+
+        // 可用内存需要轮询；轮询同时负责上限
+        readiness.poll = new QTimer(this);
+        connect(readiness.poll, &QTimer::timeout, this, [this](){ checkReadiness(); });
+        readiness.poll->start(READINESS_POLL_MS);
+    }
+
+    void checkReadiness() {
+        if(!readiness.poll) return;
+        if(readiness.memoryMs < 0) {
+            const qint64 freeMB = availableMemoryMB();
+            if(freeMB < 0 || freeMB >= readiness.minFreeMemoryMB) readiness.memoryMs = readiness.clock.elapsed();
+        }
+        const bool ready = readiness.warmupMs >= 0 && readiness.rendererMs >= 0 && readiness.memoryMs >= 0;
+        const qint64 elapsed = readiness.clock.elapsed();
+        if(!ready && elapsed < readiness.capMs) return;
+
+        readiness.poll->deleteLater();
+        readiness.poll = nullptr;
+        disconnect(readiness.warmupLoaded);
+
+        if(ready) {
+            ZDF_LOG_EVENT(CatStartup, L_INFO,
+                          "渐进式加载：%1 ms 就绪（预热页 %2 ms，渲染进程响应 %3 ms，内存充足 %4 ms），较固定等待 %5 ms 节省 %6 ms",
+                          elapsed, readiness.warmupMs, readiness.rendererMs, readiness.memoryMs,
+                          readiness.capMs, qMax<qint64>(0, readiness.capMs - elapsed));
+        } else {
+            QStringList pending;
+            if(readiness.warmupMs < 0) pending << "预热页";
+            if(readiness.rendererMs < 0) pending << "渲染进程响应";
+            if(readiness.memoryMs < 0) pending << QString("可用内存达到%1MB").arg(readiness.minFreeMemoryMB);
+            ZDF_LOG_EVENT(CatStartup, L_WARNING, "渐进式加载：%1 ms 内未就绪（%2），按上限打开考试页面",
+                          readiness.capMs, pending.join("、"));
+        }
+        loadExamPage();
+        Logger::instance().appEvent("延迟加载完成，正在访问考试页面", L_INFO);
+    }
+
+    // 启动时间线：预热页和考试页面的加载事件分别记录，考试页面加载完成后的首次绘制作为启动结束，
+    // 同时撤下启动画面
+    static const int FIRST_PAINT_TIMEOUT_MS = 10000;   // 页面加载完成后迟迟没有绘制时仍结束启动
+    static const int SPLASH_MAX_MS = 90000;            // 页面始终未加载完成时，最迟在此时撤下启动画面
+
+    void loadExamPage() {
+        StartupTimeline::instance().mark("load");
+        examLoadRequested = true;
+        load(QUrl(ConfigManager::instance().snapshot().url));
+    }
+
+    void traceLoadEvents() {
+        connect(this, &QWebEngineView::loadStarted, this, [this](){
+            HttpCacheStats::instance().collect(page());     // 跳转前取回上一页面的计数
+            RequestTiming::instance().collect(page());
+            RequestTiming::instance().pageLoadStarted();
+            StartupTimeline::instance().mark(examLoadRequested ? "loadStarted" : "warmup.loadStarted");
+        });
+        connect(this, &QWebEngineView::loadProgress, this, [this](int progress){
+            StartupTimeline::instance().mark(examLoadRequested ? "loadProgress" : "warmup.loadProgress",
+                                             QString::number(progress), false);
+            if(splash && examLoadRequested) splash->setStatus(QString("正在打开考试页面 %1%").arg(progress));
+        });
+        connect(this, &QWebEngineView::loadFinished, this, [this](bool ok){
+            RequestTiming::instance().pageLoadFinished(page(), ok);
+            StartupTimeline &timeline = StartupTimeline::instance();
+            if(timeline.isFinished()) return;
+            timeline.mark(examLoadRequested ? "loadFinished" : "warmup.loadFinished", ok ? "ok" : "failed");
+            if(!examLoadRequested) return;
+            examLoadFinished = true;
+            HttpCacheStats::instance().collect(page(), [](){
+                HttpCacheStats::instance().log(CatStartup, "考试页面首次加载");
+                if(AssetPack::instance().isOpen()) AssetPack::instance().logStats(CatStartup, "考试页面首次加载资源包");
+                RequestTiming::instance().logSummary(CatStartup, "考试页面首次加载");
+            });
+            QTimer::singleShot(FIRST_PAINT_TIMEOUT_MS, this, [this](){ startupComplete(); });
+        });
+        if(splash) QTimer::singleShot(SPLASH_MAX_MS, this, [this](){ closeSplash(); });
+    }
+
+    void startupComplete() {
+        closeSplash();
+        StartupTimeline &timeline = StartupTimeline::instance();
+        if(timeline.isFinished()) return;
+        QString tracePath;
+        if(ConfigManager::instance().snapshot().log.startupTrace && Logger::instance().ensureLogDirectoryExists())
+            tracePath = Logger::instance().logDirectory() +
+                        QDateTime::currentDateTime().toString("'/startup-trace-'yyyyMMdd-HHmmss'.json'");
+        timeline.finish(tracePath);
+    }
+
+    void closeSplash() {
+        if(!splash) return;
+        splash->close();
+        splash = nullptr;
+        StartupTimeline::instance().mark("splashClosed");
+        raise(); activateWindow();
+    }
+
+    // 网页内容绘制在 WebEngine 创建的子控件上，对其绘制事件计时
+    bool eventFilter(QObject *obj, QEvent *e) override {
+        if(e->type()==QEvent::Paint && !StartupTimeline::instance().isFinished()) {
+            if(!firstPaintSeen) {
+                firstPaintSeen = true;
+                StartupTimeline::instance().mark("firstPaint", examLoadRequested ? "page" : "warmup");
+            }
+            if(examLoadFinished && !startupDone) {
+                startupDone = true;
+                StartupTimeline::instance().mark("examFirstPaint");
+                // 绘制事件中不能关闭窗口，回到事件循环后再切换
+                QTimer::singleShot(0, this, [this](){ startupComplete(); });
+            }
+        }
+        return QWebEngineView::eventFilter(obj,e);
+    }
+
+    int maintenanceIntervalFor(const AppConfig &conf) const {
+        return conf.maintenanceIntervalMs > 0 ? conf.maintenanceIntervalMs : autoMaintenanceInterval;
+    }
+
     // ---------- 关键修改：更细粒度拦截 ----------
     bool event(QEvent *e) override {
+        if(e->type()==QEvent::ChildAdded && !StartupTimeline::instance().isFinished()){
+            QObject *child=static_cast<QChildEvent*>(e)->child();
+            if(child->isWidgetType()) child->installEventFilter(this);
+        }
         if(e->type()==QEvent::ShortcutOverride){
             QKeyEvent *k=static_cast<QKeyEvent*>(e);
 
@@ -470,11 +552,20 @@ protected:
     void contextMenuEvent(QContextMenuEvent *e) override { e->ignore(); }
 
     void handleExitHotkey(){
+        closeSplash();      // 密码框不能被启动画面遮住
         needFocusCheck=false;
         QString pwd; bool ok=Logger::instance().getPassword(this,"安全退出","请输入退出密码：",pwd);
-        QString exitPwd=ConfigManager::instance().getExitPassword();
+        QString exitPwd=ConfigManager::instance().snapshot().exitPassword;
         if(ok && pwd==exitPwd){
             Logger::instance().hotkeyEvent("密码正确，退出");
+            KeystrokeStats::instance().flush();
+            HttpCacheStats::instance().log(CatApp, "本次会话HTTP缓存");
+            if(AssetPack::instance().isOpen()) AssetPack::instance().logStats(CatApp, "本次会话资源包");
+            logAssetPackSharing(CatApp, "本次会话同伴共享");
+            BlockedRequestStats::instance().flush();
+            BlockedRequestStats::instance().logSession();
+            RequestTiming::instance().logSummary(CatNet, "本次会话网络耗时");
+            if(ConfigManager::instance().snapshot().requestTiming.exportOnExit) RequestTiming::instance().exportHar("退出");
             Logger::instance().shutdown();
             QApplication::quit();
         }else{
@@ -488,8 +579,7 @@ protected:
     void focusOutEvent(QFocusEvent *e) override { QWebEngineView::focusOutEvent(e); }
 
     void keyPressEvent(QKeyEvent *e) override {
-        QString ks=QKeySequence(e->key()|e->modifiers()).toString();
-        Logger::instance().appEvent(QString("按键事件: %1").arg(ks));
+        KeystrokeStats::instance().record(e);
 
         if(e->key()==Qt::Key_R && e->modifiers()==Qt::ControlModifier){
             reload(); e->accept(); return;
@@ -513,6 +603,9 @@ protected:
             if(hasSysMod){
                 if(k->key()==Qt::Key_R && k->modifiers()==Qt::ControlModifier)
                     return false;        // 允许 Ctrl+R
+                if(k->key()==Qt::Key_H && k->modifiers()==(Qt::ControlModifier|Qt::ShiftModifier))
+                    return false;        // 允许 Ctrl+Shift+H（导出请求计时）
+                KeystrokeStats::instance().recordBlocked(k);
                 ev->accept(); return true; // 其余带系统修饰符全部拦截
             }
 
@@ -520,7 +613,7 @@ protected:
             if( (k->key()==Qt::Key_Tab && (k->modifiers()&Qt::AltModifier)) ||
                 (k->key()==Qt::Key_Tab && (k->modifiers()&Qt::MetaModifier)) ||
                 (k->key()==Qt::Key_Delete && (k->modifiers()&(Qt::ControlModifier|Qt::AltModifier))) )
-                { ev->accept(); return true; }
+                { KeystrokeStats::instance().recordBlocked(k); ev->accept(); return true; }
         }
 
         if(ev->type()==QEvent::WindowStateChange){
@@ -536,8 +629,110 @@ protected:
     }
 };
 
+// --------------------------- 配置热更新 ---------------------------
+// 监视当前配置文件，变化后重新校验并与旧快照逐项比较，只应用有变化且可在运行中生效的字段；
+// 其余字段记录为“需重启生效”。编辑器常以“写临时文件再改名”的方式保存，
+// 因此同时监视所在目录，文件被替换后重新加入监视。
+class ConfigReloader {
+public:
+    static const int RELOAD_DEBOUNCE_MS = 500;  // 合并一次保存触发的多个变更通知
+
+    ConfigReloader(const QString &path, ShellBrowser &browser)
+        : m_path(QFileInfo(path).absoluteFilePath()), m_browser(browser) {
+        m_debounce.setSingleShot(true);
+        m_debounce.setInterval(RELOAD_DEBOUNCE_MS);
+        QObject::connect(&m_debounce, &QTimer::timeout, [this](){ reload(); });
+        QObject::connect(&m_watcher, &QFileSystemWatcher::fileChanged, [this](const QString &){ m_debounce.start(); });
+        QObject::connect(&m_watcher, &QFileSystemWatcher::directoryChanged, [this](const QString &){
+            if (!m_watcher.files().contains(m_path) && QFileInfo::exists(m_path)) m_debounce.start();
+        });
+        m_watcher.addPath(QFileInfo(m_path).absolutePath());
+        m_watcher.addPath(m_path);
+    }
+
+private:
+    void reload() {
+        if (!m_watcher.files().contains(m_path) && QFileInfo::exists(m_path)) m_watcher.addPath(m_path);
+
+        ConfigManager &cfg = ConfigManager::instance();
+        const AppConfig &old = cfg.snapshot();   // 旧快照不会被释放，引用在重新加载后仍有效
+        if (!cfg.reloadActive()) return;
+        const AppConfig &now = cfg.snapshot();
+
+        QStringList applied = m_browser.applyConfig(old, now);
+        if (now.log.level != old.log.level) {
+            Logger::instance().setLogLevel(now.log.level);
+            applied << "log.level";
+        }
+        if (now.log.maxFileSizeMB != old.log.maxFileSizeMB || now.log.maxBackups != old.log.maxBackups) {
+            Logger::instance().setRotationPolicy(qint64(now.log.maxFileSizeMB) * 1024 * 1024, now.log.maxBackups);
+            applied << "log.maxFileSizeMB/maxBackups";
+        }
+        if (now.log.binaryFormat != old.log.binaryFormat) {
+            Logger::instance().setBinaryFormat(now.log.binaryFormat);
+            applied << "log.format";
+        }
+        if (now.keystroke.summaryMinutes != old.keystroke.summaryMinutes ||
+            now.keystroke.logEveryKey != old.keystroke.logEveryKey) {
+            KeystrokeStats::instance().configure(now.keystroke.summaryMinutes, now.keystroke.logEveryKey);
+            applied << "keystroke";
+        }
+        if (now.exitPassword != old.exitPassword) applied << "exitPassword";  // 退出时读取快照，无需额外处理
+        if (now.urlFilter.enabled != old.urlFilter.enabled || now.urlFilter.allow != old.urlFilter.allow ||
+            now.urlFilter.deny != old.urlFilter.deny) applied << "urlFilter";    // 拦截器每个请求读取快照
+        if (now.requestTiming.maxEntries != old.requestTiming.maxEntries ||
+            now.requestTiming.exportOnExit != old.requestTiming.exportOnExit) applied << "requestTiming.maxEntries/exportOnExit";
+
+        QStringList restart;
+        if (now.disableHardwareAcceleration != old.disableHardwareAcceleration) restart << "disableHardwareAcceleration";
+        if (now.lowMemory.enabled != old.lowMemory.enabled ||
+            now.lowMemory.memoryThresholdMB != old.lowMemory.memoryThresholdMB ||
+            now.lowMemory.progressiveLoading != old.lowMemory.progressiveLoading ||
+            now.lowMemory.progressiveLoadingDelayMs != old.lowMemory.progressiveLoadingDelayMs) restart << "lowMemoryMode";
+        if (now.log.crashRingKB != old.log.crashRingKB) restart << "log.crashRingKB";
+        if (now.profiles.replaceBuiltin != old.profiles.replaceBuiltin ||
+            now.profiles.rules != old.profiles.rules) restart << "performanceProfiles";
+        if (now.httpCache.type != old.httpCache.type || now.httpCache.path != old.httpCache.path ||
+            now.httpCache.maxSizeMB != old.httpCache.maxSizeMB || now.httpCache.maxAgeDays != old.httpCache.maxAgeDays ||
+            now.httpCache.clearOnUrlChange != old.httpCache.clearOnUrlChange) restart << "httpCache";
+        if (now.assetPack.path != old.assetPack.path) restart << "assetPack";
+        if (now.requestTiming.enabled != old.requestTiming.enabled) restart << "requestTiming.enabled";
+        if (now.peerShare.enabled != old.peerShare.enabled || now.peerShare.discoveryPort != old.peerShare.discoveryPort ||
+            now.peerShare.port != old.peerShare.port || now.peerShare.peers != old.peerShare.peers ||
+            now.peerShare.maxUploads != old.peerShare.maxUploads) restart << "peerShare";
+
+        if (applied.isEmpty() && restart.isEmpty()) {
+            ZDF_LOG_CONFIG(L_INFO, "配置文件已变化，内容无影响运行的修改");
+            return;
+        }
+        if (!applied.isEmpty())
+            ZDF_LOG_CONFIG(L_INFO, "配置已热更新：%1", applied.join("，"));
+        if (!restart.isEmpty())
+            ZDF_LOG_CONFIG(L_WARNING, "以下配置修改需重启程序后生效：%1", restart.join("，"));
+    }
+
+    const QString m_path;
+    ShellBrowser &m_browser;
+    QFileSystemWatcher m_watcher;
+    QTimer m_debounce;
+};
+
 // --------------------------- main ---------------------------
+// 程序所在目录：QApplication 创建前不能调用 applicationDirPath，按与 Qt 相同的方式自行获取
+static QString executableDir(const char *argv0) {
+#if defined(Q_OS_WIN)
+    wchar_t buffer[MAX_PATH];
+    const DWORD length = GetModuleFileNameW(nullptr, buffer, MAX_PATH);
+    if (length > 0 && length < MAX_PATH) return QFileInfo(QString::fromWCharArray(buffer, int(length))).absolutePath();
+#elif defined(Q_OS_LINUX)
+    const QString exe = QFileInfo("/proc/self/exe").canonicalFilePath();
+    if (!exe.isEmpty()) return QFileInfo(exe).absolutePath();
+#endif
+    return QFileInfo(QString::fromLocal8Bit(argv0)).absolutePath();
+}
+
 int main(int argc,char *argv[]){
+    StartupTimeline &timeline = StartupTimeline::instance();    // 启动时间线以此为零点
 #ifdef Q_OS_WIN
     // 针对0x40000015异常的Windows特殊处理
     SetErrorMode(SEM_FAILCRITICALERRORS | SEM_NOGPFAULTERRORBOX);
@@ -548,61 +743,50 @@ int main(int argc,char *argv[]){
     // 这只是尝试，失败也不影响程序继续
 #endif
 
-    // Windows 7 WebEngine兼容性：在QApplication创建前设置环境变量
+    // 应用名和组织名决定配置与缓存目录，须在预取配置前设置
+    QCoreApplication::setApplicationName("DesktopTerminal"); QCoreApplication::setOrganizationName("智多分");
+
+    // 考前预取：不创建界面，下载清单中的资源、生成本地资源包后退出
+    if (hasStageFlag(argc, argv)) return runStaging(argc, argv);
+
+    // 配置文件的读取、解析和校验在后台线程进行，与下面的系统信息探测和QApplication初始化重叠
+    ConfigManager::instance().prefetchConfig(executableDir(argv[0]));
+
+    // 性能档案：QT_OPENGL 等平台环境变量须在QApplication创建前设置，此时配置尚未加载，只用内置规则；
+    // 配置加载后再按完整规则表重新计算一次（WebEngine 在首个页面创建时才读取 Chromium 参数）
+    const int sysInfoSpan = timeline.begin("detectSystemInfo");
+    const SystemInfo &sysInfo = systemInfo();   // 进程内只探测一次，可命中磁盘缓存
+    timeline.end(sysInfoSpan, sysInfo.fromCache ? "cache" : "probe");
 #ifdef Q_OS_WIN
-    // 使用统一的系统检测函数
-    SystemInfo sysInfo = detectSystemInfo();
-    
     if(sysInfo.isOldWin) {
         // 创建Logger输出信息（这里Logger还没初始化，用printf）
         printf("检测到Windows 7系统\n");
         printf("CPU信息：%s\n", sysInfo.cpuInfo.toLocal8Bit().constData());
         printf("内存大小：%lld MB\n", sysInfo.totalMemoryMB);
-        printf("CPU架构：%s\n", sysInfo.isOldCpu ? "老旧架构(Haswell或更早)" : "较新架构");
+        printf("CPU性能评分：%d（%s）\n", sysInfo.capabilityScore, sysInfo.isOldCpu ? "低配置" : "标准");
         printf("虚拟化环境：%s\n", sysInfo.isVirtualized ? "是" : "否");
-        
-        // Windows 7最兼容配置：只使用最基础、最稳定的设置
-        qputenv("QTWEBENGINE_DISABLE_GPU", "1");
-        qputenv("QTWEBENGINE_DISABLE_SANDBOX", "1");
-        qputenv("QT_OPENGL", "software");
-        
-        // 虚拟化环境专用优化
-        if(sysInfo.isVirtualized) {
-            printf("检测到虚拟化环境，启用虚拟化优化模式\n");
-            qputenv("QTWEBENGINE_DISABLE_GPU_PROCESS", "1");
-            qputenv("QTWEBENGINE_DISABLE_SOFTWARE_RASTERIZER", "1");
-        }
-        
-        // Chrome启动参数：针对虚拟化单核心环境的最小化配置
-        QString chromiumFlags = "--no-sandbox --single-process --disable-dev-shm-usage "
-                              "--disable-extensions --disable-plugins ";
-        
-        if(sysInfo.isVirtualized && (sysInfo.lowMemory || sysInfo.isOldCpu)) {
-            // 虚拟化超保守模式：最小化资源占用
-            printf("启用虚拟化超保守模式\n");
-            chromiumFlags += "--max_old_space_size=64 --disable-webgl --disable-webgl2 "
-                           "--disable-3d-apis --use-gl=disabled --disable-gpu "
-                           "--disable-accelerated-video-processing --disable-features=WebRTC "
-                           "--renderer-process-limit=1 --disable-smooth-scrolling "
-                           "--disable-background-networking --disable-renderer-backgrounding "
-                           "--memory-pressure-off --max-unused-resource-memory-usage-percentage=5";
-        } else if(sysInfo.lowMemory || sysInfo.isOldCpu) {
-            // 标准保守模式
-            printf("启用标准保守模式\n");
-            chromiumFlags += "--max_old_space_size=128 --disable-webgl "
-                           "--disable-accelerated-video-processing "
-                           "--renderer-process-limit=1 --disable-smooth-scrolling";
-        } else {
-            // 标准Windows 7模式
-            printf("启用标准Windows 7兼容模式\n");
-            chromiumFlags += "--max_old_space_size=256";
-        }
-        
-        qputenv("QTWEBENGINE_CHROMIUM_FLAGS", chromiumFlags.toLocal8Bit());
     }
 #endif
+#ifdef Q_OS_LINUX
+    printf("CPU信息：%s（可用%d核）\n", sysInfo.cpuInfo.toLocal8Bit().constData(), sysInfo.cpuCores);
+    printf("可用内存：%llu MB\n", (unsigned long long)sysInfo.totalMemoryMB);
+    printf("虚拟化环境：%s\n", sysInfo.isVirtualized ? sysInfo.virtualization.toLocal8Bit().constData() : "否");
+#endif
+    const PerformanceProfile earlyProfile = resolvePerformanceProfile(sysInfo);
+    applyProfileEnvironment(earlyProfile);
+    printf("性能档案：%s\n", earlyProfile.rules.isEmpty() ? "默认" : earlyProfile.rules.join(" ").toLocal8Bit().constData());
 
+    AssetPack::registerScheme();    // 自定义协议须在QApplication创建前注册
+
+    const int appSpan = timeline.begin("QApplication");
     QApplication app(argc,argv);
+    timeline.end(appSpan);
+
+    // 先显示原生启动画面，用户不必对着黑屏等待 Chromium 渲染进程启动
+    StartupSplash splash;
+    splash.showFullScreen();
+    app.processEvents();
+    timeline.mark("splash");
     
     // 强制Qt使用单线程模式
     app.setAttribute(Qt::AA_DisableHighDpiScaling, true);  // 禁用高DPI缩放以减少计算
@@ -614,7 +798,6 @@ int main(int argc,char *argv[]){
     SetConsoleOutputCP(CP_UTF8); SetConsoleCP(CP_UTF8);
 #endif
 
-    app.setApplicationName("DesktopTerminal"); app.setOrganizationName("智多分");
     app.setQuitOnLastWindowClosed(false);
 
 #ifdef Q_OS_MAC
@@ -626,25 +809,71 @@ int main(int argc,char *argv[]){
 #else
     Logger::instance().setLogLevel(L_INFO);
 #endif
-    Logger::instance().ensureLogDirectoryExists();
     Logger::instance().appEvent("应用程序初始化...");
 
     ConfigManager &cfg=ConfigManager::instance();
-    if(!cfg.loadConfig()){
+    const int configSpan = timeline.begin("loadConfig");
+    const bool configLoaded = cfg.loadConfig();
+    timeline.end(configSpan);
+    if(!configLoaded){
         QString p=QCoreApplication::applicationDirPath()+"/config.json";
+        splash.hide();      // 启动画面置顶，提示框须在其隐藏后弹出
         if(cfg.createDefaultConfig(p)&&cfg.loadConfig(p)){
             QMessageBox::information(nullptr,"提示",
                 QString("已生成默认配置文件：\n%1\n请修改后重新启动。").arg(p));
+            splash.showFullScreen();
         }else{
             QMessageBox::critical(nullptr,"错误","无法加载或创建配置文件，程序退出。");
             return 1;
         }
     }
-    Logger::instance().logStartup(cfg.getActualConfigPath());
+    const AppConfig &conf = cfg.snapshot();
+    Logger::instance().setLogLevel(conf.log.level);
+    Logger::instance().setRotationPolicy(qint64(conf.log.maxFileSizeMB) * 1024 * 1024, conf.log.maxBackups);
+    Logger::instance().setBinaryFormat(conf.log.binaryFormat);
+    // 日志目录、超限文件轮转和崩溃保护环的映射与恢复都交给写日志线程，界面线程直接创建浏览器
+    Logger::instance().prepareFilesInBackground();
+    Logger::instance().enableCrashRingInBackground(qint64(conf.log.crashRingKB) * 1024);
+    KeystrokeStats::instance().configure(conf.keystroke.summaryMinutes, conf.keystroke.logEveryKey);
+    Logger::instance().logStartup(conf.sourcePath);
 
     GlobalEventFilter *f=new GlobalEventFilter; app.installEventFilter(f);
 
-    ShellBrowser browser; browser.showFullScreen();
-    QObject::connect(&app,&QApplication::aboutToQuit,[](){ Logger::instance().shutdown(); });
+    // WebEngine 初始化和渲染进程启动尽量提前：档案确定后立即创建浏览器，其余启动日志放在之后
+    const PerformanceProfile profile = resolvePerformanceProfile(systemInfo(), &conf);
+    applyProfileEnvironment(profile);
+
+    // HTTP缓存、本地资源包和请求拦截器须在首个页面创建前设置
+    const int cacheSpan = timeline.begin("httpCache");
+    configureHttpCache(QWebEngineProfile::defaultProfile(), conf);
+    HttpCacheStats::instance().attach(QWebEngineProfile::defaultProfile());
+    RequestTiming::instance().attach(QWebEngineProfile::defaultProfile(), conf);
+    installAssetPack(QWebEngineProfile::defaultProfile(), conf);
+    installRequestInterceptor(QWebEngineProfile::defaultProfile());
+    shareAssetPack(conf);
+    timeline.end(cacheSpan);
+
+    const int browserSpan = timeline.begin("ShellBrowser");
+    ShellBrowser browser(systemInfo(), profile, &splash); browser.showFullScreen();
+    if(splash.isVisible()) splash.raise();
+    timeline.end(browserSpan);
+
+    logPerformanceProfile(profile);
+    ZDF_LOG_EVENT(CatStartup, L_INFO, "系统信息：%1，耗时 %2 ms",
+                  systemInfo().fromCache ? "读取缓存" : "实时探测", systemInfo().probeMs);
+    // 原始测量值便于按机型汇总分析、调整评分阈值
+    static const char *const PROFILE_NAMES[] = {"低", "标准", "高"};
+    ZDF_LOG_EVENT(CatStartup, L_INFO, "性能评分：%1（%2档） CPU %3 Mops/s，内存 %4 MB/s",
+                  systemInfo().capabilityScore, PROFILE_NAMES[systemInfo().profile],
+                  systemInfo().cpuMops, systemInfo().memoryMBps);
+    ZDF_LOG_EVENT(CatStartup, L_INFO, "性能评分明细：磁盘落盘 %1 ms，可用核心 %2，CPU：%3",
+                  systemInfo().storageWriteMs, systemInfo().cpuCores, systemInfo().cpuInfo);
+    revalidateSystemInfoCache();
+
+    ConfigReloader configReloader(cfg.getActualConfigPath(), browser);
+    QObject::connect(&app,&QApplication::aboutToQuit,[](){
+        KeystrokeStats::instance().flush();
+        Logger::instance().shutdown();
+    });
     return app.exec();
 }
@@ -0,0 +1,124 @@
+#include "packbuilder.h"
+#include "packformat.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDirIterator>
+#include <QMimeDatabase>
+#include <QHash>
+#include <QDateTime>
+#include <QUrl>
+
+#include <algorithm>
+#include <vector>
+
+namespace zdfpack {
+
+struct SourceFile {
+    QByteArray path;        // 相对资源目录，"/" 分隔的 UTF-8
+    QString filePath;
+    quint64 size;
+    quint32 pathOffset;
+    quint32 mimeOffset, mimeLength;
+    quint64 dataOffset;
+};
+
+static bool fail(BuildResult &result, const QString &error) {
+    result.error = error;
+    return false;
+}
+
+bool buildPack(const QString &dir, const QString &baseUrl, const QString &outputPath,
+               BuildResult &result, const QString &skipSuffix) {
+    const QUrl base(baseUrl);
+    if (!base.isValid() || base.host().isEmpty() || !baseUrl.endsWith('/'))
+        return fail(result, QString("基准地址应为以 / 结尾的完整地址，例如 http://stu.sdzdf.com/"));
+    const QDir root(dir);
+    if (!root.exists()) return fail(result, QString("资源目录不存在: %1").arg(dir));
+
+    std::vector<SourceFile> files;
+    QDirIterator it(root.absolutePath(), QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo fi = it.fileInfo();
+        if (!skipSuffix.isEmpty() && fi.fileName().endsWith(skipSuffix)) continue;
+        if (fi.absoluteFilePath() == QFileInfo(outputPath).absoluteFilePath()) continue;
+        files.push_back(SourceFile{root.relativeFilePath(fi.absoluteFilePath()).toUtf8(), fi.absoluteFilePath(),
+                                   quint64(fi.size()), 0, 0, 0, 0});
+    }
+    // 程序按 UTF-8 字节序二分查找
+    std::sort(files.begin(), files.end(), [](const SourceFile &a, const SourceFile &b) {
+        return qstrcmp(a.path, b.path) < 0;
+    });
+
+    // 字符串区：基准地址、各路径、去重后的 MIME 类型
+    QByteArray strings = baseUrl.toUtf8();
+    QHash<QByteArray, quint32> mimeOffsets;
+    QMimeDatabase mimeDb;
+    for (SourceFile &f : files) {
+        f.pathOffset = quint32(strings.size());
+        strings.append(f.path);
+        const QByteArray mime = mimeDb.mimeTypeForFile(f.filePath, QMimeDatabase::MatchExtension).name().toUtf8();
+        if (!mimeOffsets.contains(mime)) {
+            mimeOffsets.insert(mime, quint32(strings.size()));
+            strings.append(mime);
+        }
+        f.mimeOffset = mimeOffsets.value(mime);
+        f.mimeLength = quint32(mime.size());
+    }
+
+    Header header;
+    header.entryCount = quint32(files.size());
+    header.indexOffset = HEADER_SIZE;
+    header.stringsOffset = header.indexOffset + quint64(files.size()) * ENTRY_SIZE;
+    header.stringsSize = quint64(strings.size());
+    header.dataOffset = alignUp(header.stringsOffset + header.stringsSize);
+    header.baseUrlOffset = 0;
+    header.baseUrlLength = quint32(baseUrl.toUtf8().size());
+    header.createdMs = QDateTime::currentMSecsSinceEpoch();
+
+    quint64 offset = header.dataOffset;
+    for (SourceFile &f : files) {
+        f.dataOffset = offset;
+        offset = alignUp(offset + f.size);
+    }
+
+    QByteArray head;
+    appendHeader(head, header);
+    for (const SourceFile &f : files)
+        appendEntry(head, f.pathOffset, quint32(f.path.size()), f.dataOffset, f.size, f.mimeOffset, f.mimeLength);
+    head.append(strings);
+
+    QSaveFile out(outputPath);
+    if (!out.open(QIODevice::WriteOnly)) return fail(result, QString("无法写入文件: %1").arg(outputPath));
+    out.write(head);
+    quint64 written = quint64(head.size());
+    for (const SourceFile &f : files) {
+        out.write(QByteArray(int(f.dataOffset - written), '\0'));
+        QFile in(f.filePath);
+        if (!in.open(QIODevice::ReadOnly)) {
+            out.cancelWriting();
+            return fail(result, QString("无法读取文件: %1").arg(f.filePath));
+        }
+        quint64 copied = 0;
+        while (!in.atEnd()) {
+            const QByteArray chunk = in.read(1 << 20);
+            if (chunk.isEmpty()) break;
+            out.write(chunk);
+            copied += quint64(chunk.size());
+        }
+        if (copied != f.size) {
+            out.cancelWriting();
+            return fail(result, QString("文件在打包过程中被修改: %1").arg(f.filePath));
+        }
+        written = f.dataOffset + f.size;
+    }
+    if (!out.commit()) return fail(result, QString("写入失败: %1").arg(outputPath));
+    result.files = int(files.size());
+    result.bytes = written;
+    return true;
+}
+
+} // namespace zdfpack
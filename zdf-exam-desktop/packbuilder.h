@@ -0,0 +1,22 @@
+#ifndef ZDF_PACKBUILDER_H
+#define ZDF_PACKBUILDER_H
+
+#include <QString>
+
+// --------------------------- 资源包生成 ---------------------------
+// 由 zdf-pack 和 --stage 预取共用：把按服务器路径组织的资源目录打包为资源包（格式见 packformat.h）。
+// 目录下以 skipSuffix 结尾的文件（如未下载完的临时文件）不打包。输出经临时文件原子替换
+namespace zdfpack {
+
+struct BuildResult {
+    int files = 0;
+    quint64 bytes = 0;          // 资源包总大小
+    QString error;              // 失败原因
+};
+
+bool buildPack(const QString &dir, const QString &baseUrl, const QString &outputPath,
+               BuildResult &result, const QString &skipSuffix = QString());
+
+} // namespace zdfpack
+
+#endif // ZDF_PACKBUILDER_H
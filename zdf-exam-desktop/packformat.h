@@ -0,0 +1,177 @@
+#ifndef ZDF_PACKFORMAT_H
+#define ZDF_PACKFORMAT_H
+
+#include <QByteArray>
+#include <QtEndian>
+
+#include <climits>
+#include <cstring>
+
+// --------------------------- 资源包格式 ---------------------------
+// 考试页面静态资源（JS、CSS、图片、音频）打包为单个文件，由程序整体映射到内存后直接读取。
+// 所有整数均为小端序，文件依次为：
+//   文件头（64 字节）: "ZDFP" | u16 version | u16 保留 | u32 条目数 | u32 保留
+//                     | u64 索引偏移 | u64 字符串区偏移 | u64 字符串区长度 | u64 数据区偏移
+//                     | u32 基准地址偏移 | u32 基准地址长度 | i64 打包时间（毫秒）
+//   索引（每条 32 字节，按路径的 UTF-8 字节序升序）:
+//                       u32 路径偏移 | u32 路径长度 | u64 数据偏移 | u64 数据长度
+//                     | u32 MIME 偏移 | u32 MIME 长度
+//   字符串区: 基准地址、路径（相对基准地址，"/" 分隔，不含查询参数）、MIME 类型
+//   数据区: 各文件内容，按 DATA_ALIGN 对齐
+// 路径和 MIME 的偏移相对字符串区起点，数据偏移为文件内的绝对偏移。
+namespace zdfpack {
+
+static const char MAGIC[4] = {'Z', 'D', 'F', 'P'};
+static const quint16 FORMAT_VERSION = 1;
+static const int HEADER_SIZE = 64;
+static const int ENTRY_SIZE = 32;
+static const int DATA_ALIGN = 16;
+static const char PACK_SUFFIX[] = ".zpack";
+
+template<typename T>
+inline T readLE(const uchar *p) { return qFromLittleEndian<T>(p); }
+
+template<typename T>
+inline void appendLE(QByteArray &out, T value) {
+    char buf[sizeof(T)];
+    qToLittleEndian<T>(value, reinterpret_cast<uchar*>(buf));
+    out.append(buf, sizeof(T));
+}
+
+inline quint64 alignUp(quint64 offset) { return (offset + DATA_ALIGN - 1) / DATA_ALIGN * DATA_ALIGN; }
+
+struct Header {
+    quint32 entryCount = 0;
+    quint64 indexOffset = 0;
+    quint64 stringsOffset = 0;
+    quint64 stringsSize = 0;
+    quint64 dataOffset = 0;
+    quint32 baseUrlOffset = 0;
+    quint32 baseUrlLength = 0;
+    qint64 createdMs = 0;
+};
+
+inline void appendHeader(QByteArray &out, const Header &h) {
+    out.append(MAGIC, sizeof(MAGIC));
+    appendLE<quint16>(out, FORMAT_VERSION);
+    appendLE<quint16>(out, 0);
+    appendLE<quint32>(out, h.entryCount);
+    appendLE<quint32>(out, 0);
+    appendLE<quint64>(out, h.indexOffset);
+    appendLE<quint64>(out, h.stringsOffset);
+    appendLE<quint64>(out, h.stringsSize);
+    appendLE<quint64>(out, h.dataOffset);
+    appendLE<quint32>(out, h.baseUrlOffset);
+    appendLE<quint32>(out, h.baseUrlLength);
+    appendLE<qint64>(out, h.createdMs);
+}
+
+inline void appendEntry(QByteArray &out, quint32 pathOffset, quint32 pathLength, quint64 dataOffset,
+                        quint64 size, quint32 mimeOffset, quint32 mimeLength) {
+    appendLE<quint32>(out, pathOffset);
+    appendLE<quint32>(out, pathLength);
+    appendLE<quint64>(out, dataOffset);
+    appendLE<quint64>(out, size);
+    appendLE<quint32>(out, mimeOffset);
+    appendLE<quint32>(out, mimeLength);
+}
+
+// 只读视图：open() 一次性检查文件头和全部索引的范围，之后的查找和取数据不再做边界检查，
+// 返回的 QByteArray 直接引用映射内存（不复制），映射须在其使用期间保持有效。
+// open() 之后只读，可在多个线程同时查找
+class Reader {
+public:
+    struct Entry {
+        QByteArray path;
+        QByteArray mime;
+        QByteArray data;
+    };
+
+    bool open(const uchar *base, quint64 size, const char **error = nullptr) {
+        m_base = nullptr;
+        const char *reason = check(base, size);
+        if (error) *error = reason;
+        if (reason) return false;
+        m_base = base;
+        return true;
+    }
+
+    bool isOpen() const { return m_base != nullptr; }
+    int count() const { return int(m_header.entryCount); }
+    const Header &header() const { return m_header; }
+    QByteArray baseUrl() const { return string(m_header.baseUrlOffset, m_header.baseUrlLength); }
+
+    Entry entryAt(int i) const {
+        const uchar *e = m_base + m_header.indexOffset + quint64(i) * ENTRY_SIZE;
+        return Entry{string(readLE<quint32>(e), readLE<quint32>(e + 4)),
+                     string(readLE<quint32>(e + 24), readLE<quint32>(e + 28)),
+                     QByteArray::fromRawData(reinterpret_cast<const char*>(m_base + readLE<quint64>(e + 8)),
+                                             int(readLE<quint64>(e + 16)))};
+    }
+
+    // 按路径二分查找
+    bool find(const QByteArray &path, Entry &out) const {
+        int lo = 0, hi = count();
+        while (lo < hi) {
+            const int mid = lo + (hi - lo) / 2;
+            const int c = compare(pathAt(mid), path);
+            if (c == 0) { out = entryAt(mid); return true; }
+            if (c < 0) lo = mid + 1;
+            else hi = mid;
+        }
+        return false;
+    }
+
+private:
+    QByteArray string(quint32 offset, quint32 length) const {
+        return QByteArray::fromRawData(reinterpret_cast<const char*>(m_base + m_header.stringsOffset + offset), int(length));
+    }
+
+    QByteArray pathAt(int i) const {
+        const uchar *e = m_base + m_header.indexOffset + quint64(i) * ENTRY_SIZE;
+        return string(readLE<quint32>(e), readLE<quint32>(e + 4));
+    }
+
+    static int compare(const QByteArray &a, const QByteArray &b) {
+        const int c = memcmp(a.constData(), b.constData(), size_t(qMin(a.size(), b.size())));
+        return c != 0 ? c : a.size() - b.size();
+    }
+
+    // 返回错误原因，通过时返回 nullptr
+    const char *check(const uchar *base, quint64 size) {
+        if (!base || size < quint64(HEADER_SIZE) || memcmp(base, MAGIC, sizeof(MAGIC)) != 0) return "不是资源包文件";
+        if (readLE<quint16>(base + 4) != FORMAT_VERSION) return "资源包版本不受支持";
+        Header &h = m_header;
+        h.entryCount = readLE<quint32>(base + 8);
+        h.indexOffset = readLE<quint64>(base + 16);
+        h.stringsOffset = readLE<quint64>(base + 24);
+        h.stringsSize = readLE<quint64>(base + 32);
+        h.dataOffset = readLE<quint64>(base + 40);
+        h.baseUrlOffset = readLE<quint32>(base + 48);
+        h.baseUrlLength = readLE<quint32>(base + 52);
+        h.createdMs = readLE<qint64>(base + 56);
+
+        if (h.entryCount > quint32(INT_MAX / ENTRY_SIZE) || h.indexOffset > size ||
+            quint64(h.entryCount) * ENTRY_SIZE > size - h.indexOffset) return "索引超出文件范围";
+        if (h.stringsOffset > size || h.stringsSize > size - h.stringsOffset || h.stringsSize > quint64(INT_MAX))
+            return "字符串区超出文件范围";
+        auto stringOk = [&h](quint64 offset, quint64 length) { return offset + length <= h.stringsSize; };
+        if (!stringOk(h.baseUrlOffset, h.baseUrlLength)) return "基准地址超出字符串区";
+        for (quint32 i = 0; i < h.entryCount; ++i) {
+            const uchar *e = base + h.indexOffset + quint64(i) * ENTRY_SIZE;
+            const quint64 dataOffset = readLE<quint64>(e + 8), dataSize = readLE<quint64>(e + 16);
+            if (!stringOk(readLE<quint32>(e), readLE<quint32>(e + 4)) ||
+                !stringOk(readLE<quint32>(e + 24), readLE<quint32>(e + 28))) return "索引中的路径或类型超出字符串区";
+            if (dataOffset > size || dataSize > size - dataOffset || dataSize > quint64(INT_MAX))
+                return "索引中的数据超出文件范围";
+        }
+        return nullptr;
+    }
+
+    const uchar *m_base = nullptr;
+    Header m_header;
+};
+
+} // namespace zdfpack
+
+#endif // ZDF_PACKFORMAT_H
@@ -0,0 +1,281 @@
+#include "peershare.h"
+#include "config.h"
+#include "assetpack.h"
+
+#include <QCoreApplication>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUdpSocket>
+#include <QTimer>
+#include <QBuffer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QUuid>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+const char *const PeerShare::PATH_PREFIX = "/zdf-peer/";
+const char *const PeerShare::BASE_HEADER = "X-Zdf-Base";
+
+static const int PEER_EXPIRE_MS = 3 * PeerShare::ANNOUNCE_MS;
+static const int MAX_REQUEST_HEAD = 8 * 1024;
+static const int REQUEST_TIMEOUT_MS = 10000;    // 连接后该时间内未收到完整请求头则断开
+static const qint64 SEND_CHUNK = 64 * 1024;
+static const qint64 SEND_BUFFER = 256 * 1024;   // 套接字待发送数据低于该值时继续读取文件
+
+// 组播只在本网段内传播（TTL 为 1），不经过学校的路由器
+static QHostAddress multicastGroup() {
+    return QHostAddress(QStringLiteral("239.255.43.21"));
+}
+
+// 格式已在配置编译时检查
+static QList<PeerEndpoint> parseEndpoints(const QStringList &peers) {
+    QList<PeerEndpoint> list;
+    for (const QString &peer : peers) {
+        const int colon = peer.lastIndexOf(':');
+        list.append(PeerEndpoint{QHostAddress(peer.left(colon)), quint16(peer.mid(colon + 1).toUInt())});
+    }
+    return list;
+}
+
+static void replyStatus(QTcpSocket *socket, const char *status) {
+    socket->write(QByteArray("HTTP/1.1 ") + status + "\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+    socket->disconnectFromHost();
+}
+
+// 一个连接的发送状态，由该连接上的各个槽共同持有
+struct PeerShare::Upload {
+    QByteArray head;
+    bool responded = false;
+    bool finished = false;
+    std::unique_ptr<QIODevice> body;
+    qint64 sent = 0;
+};
+
+// --------------------------- PeerShare ---------------------------
+PeerShare::PeerShare(const AppConfig &config, const QUrl &baseUrl, Source source)
+    : m_baseUrl(baseUrl), m_id(QUuid::createUuid().toString()),
+      m_discoveryPort(quint16(config.peerShare.discoveryPort)), m_listenPort(quint16(config.peerShare.port)),
+      m_maxUploads(config.peerShare.maxUploads), m_fixedPeers(parseEndpoints(config.peerShare.peers)),
+      m_source(std::move(source)) {
+    m_clock.start();
+}
+
+PeerShare::~PeerShare() = default;
+
+bool PeerShare::start() {
+    m_server.reset(new QTcpServer);
+    if (!m_server->listen(QHostAddress::AnyIPv4, m_listenPort)) {
+        ZDF_LOG_EVENT(CatApp, L_WARNING, "同伴共享无法监听端口 %1（%2），未启用", int(m_listenPort), m_server->errorString());
+        m_server.reset();
+        return false;
+    }
+    QObject::connect(m_server.get(), &QTcpServer::newConnection, [this]() { accept(); });
+
+    // 同一台机器上的多个实例共用通告端口，组播数据报每个实例都能收到
+    m_udp.reset(new QUdpSocket);
+    if (!m_udp->bind(QHostAddress::AnyIPv4, m_discoveryPort, QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint)) {
+        ZDF_LOG_EVENT(CatApp, L_WARNING, "同伴共享无法绑定通告端口 %1（%2），只使用固定同伴",
+                      int(m_discoveryPort), m_udp->errorString());
+    } else {
+        if (!m_udp->joinMulticastGroup(multicastGroup()))
+            ZDF_LOG_EVENT(CatApp, L_WARNING, "同伴共享无法加入组播组（%1），只使用固定同伴", m_udp->errorString());
+        QObject::connect(m_udp.get(), &QUdpSocket::readyRead, [this]() { readAnnouncements(); });
+    }
+    m_udp->setSocketOption(QAbstractSocket::MulticastTtlOption, 1);
+    m_udp->setSocketOption(QAbstractSocket::MulticastLoopbackOption, 1);
+
+    m_announceTimer.reset(new QTimer);
+    QObject::connect(m_announceTimer.get(), &QTimer::timeout, [this]() { announce(); });
+    m_announceTimer->start(ANNOUNCE_MS);
+    announce();
+    ZDF_LOG_EVENT(CatApp, L_INFO, "同伴共享：HTTP 端口 %1，通告端口 %2，固定同伴 %3 个，同时上传上限 %4",
+                  int(port()), int(m_discoveryPort), m_fixedPeers.size(), m_maxUploads);
+    return true;
+}
+
+quint16 PeerShare::port() const {
+    return m_server ? m_server->serverPort() : 0;
+}
+
+QUrl PeerShare::assetUrl(const PeerEndpoint &peer, const QString &path) {
+    QUrl url;
+    url.setScheme("http");
+    url.setHost(peer.address.toString());
+    url.setPort(peer.port);
+    url.setPath(QString::fromLatin1(PATH_PREFIX) + path, QUrl::DecodedMode);
+    return url;
+}
+
+QList<PeerEndpoint> PeerShare::peers() const {
+    const qint64 now = m_clock.elapsed();
+    std::vector<Peer> fresh;
+    for (const Peer &p : m_peers)
+        if (now - p.lastSeenMs <= PEER_EXPIRE_MS) fresh.push_back(p);
+    std::sort(fresh.begin(), fresh.end(), [](const Peer &a, const Peer &b) { return a.files > b.files; });
+
+    QList<PeerEndpoint> list;
+    for (const Peer &p : fresh) list.append(p.endpoint);
+    for (const PeerEndpoint &fixed : m_fixedPeers) {
+        if (fixed.port == port() && fixed.address.isLoopback()) continue;     // 本机自己
+        const bool listed = std::any_of(list.begin(), list.end(), [&fixed](const PeerEndpoint &e) {
+            return e.port == fixed.port && e.address == fixed.address;
+        });
+        if (!listed) list.append(fixed);
+    }
+    return list;
+}
+
+void PeerShare::announce() {
+    const qint64 now = m_clock.elapsed();
+    for (auto it = m_peers.begin(); it != m_peers.end(); ) {
+        if (now - it->lastSeenMs > PEER_EXPIRE_MS) it = m_peers.erase(it);
+        else ++it;
+    }
+    const QJsonObject message{{"zdf", "peer"}, {"v", 1}, {"id", m_id}, {"port", int(port())},
+                              {"base", m_baseUrl.toString()}, {"files", m_fileCount}};
+    // 没有组播路由（例如只有回环网卡）时发送失败，此时只使用固定同伴，不重复记录
+    m_udp->writeDatagram(QJsonDocument(message).toJson(QJsonDocument::Compact), multicastGroup(), m_discoveryPort);
+}
+
+void PeerShare::readAnnouncements() {
+    while (m_udp->hasPendingDatagrams()) {
+        const qint64 size = m_udp->pendingDatagramSize();
+        QByteArray data(int(qMax<qint64>(size, 0)), '\0');
+        QHostAddress sender;
+        if (m_udp->readDatagram(data.data(), data.size(), &sender) <= 0) continue;
+        const QJsonObject o = QJsonDocument::fromJson(data).object();
+        const QString id = o.value("id").toString();
+        const int peerPort = o.value("port").toInt();
+        if (o.value("zdf").toString() != "peer" || id.isEmpty() || id == m_id ||
+            o.value("base").toString() != m_baseUrl.toString() || peerPort <= 0 || peerPort > 65535) continue;
+        const int files = o.value("files").toInt();
+        const bool known = m_peers.contains(id);
+        m_peers.insert(id, Peer{PeerEndpoint{QHostAddress(sender.toIPv4Address()), quint16(peerPort)},
+                                files, m_clock.elapsed()});
+        if (!known)
+            ZDF_LOG_EVENT(CatApp, L_INFO, "发现同伴 %1:%2（%3 个文件）", sender.toString(), peerPort, files);
+    }
+}
+
+// --------------------------- HTTP 服务 ---------------------------
+void PeerShare::accept() {
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        auto upload = std::make_shared<Upload>();
+        QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        QObject::connect(socket, &QTcpSocket::readyRead, socket, [this, socket, upload]() {
+            if (upload->responded) {
+                socket->readAll();
+                return;
+            }
+            upload->head += socket->readAll();
+            const int end = upload->head.indexOf("\r\n\r\n");
+            if (end < 0) {
+                if (upload->head.size() > MAX_REQUEST_HEAD) socket->abort();
+                return;
+            }
+            upload->responded = true;
+            respond(socket, upload, upload->head.left(end));
+        });
+        QTimer::singleShot(REQUEST_TIMEOUT_MS, socket, [socket, upload]() {
+            if (!upload->responded) socket->abort();
+        });
+    }
+}
+
+void PeerShare::respond(QTcpSocket *socket, const std::shared_ptr<Upload> &upload, const QByteArray &head) {
+    const QList<QByteArray> lines = head.split('\n');
+    const QList<QByteArray> requestLine = lines.value(0).trimmed().split(' ');
+    QByteArray base;
+    for (int i = 1; i < lines.size(); ++i) {
+        const QByteArray line = lines.at(i).trimmed();
+        const int colon = line.indexOf(':');
+        if (colon > 0 && qstricmp(line.left(colon).trimmed().constData(), BASE_HEADER) == 0)
+            base = line.mid(colon + 1).trimmed();
+    }
+    if (requestLine.size() != 3 || requestLine.at(0) != "GET" || !requestLine.at(1).startsWith(PATH_PREFIX)) {
+        replyStatus(socket, "400 Bad Request");
+        return;
+    }
+    // 基准地址不同说明是另一场考试的资源，同一路径的内容未必相同
+    if (QString::fromUtf8(base) != m_baseUrl.toString()) {
+        ++m_notFound;
+        replyStatus(socket, "404 Not Found");
+        return;
+    }
+    if (m_uploads >= m_maxUploads) {
+        ++m_busy;
+        replyStatus(socket, "503 Service Unavailable");
+        return;
+    }
+    const QString path = QUrl::fromPercentEncoding(requestLine.at(1).mid(int(strlen(PATH_PREFIX))));
+    QIODevice *body = m_source(path);
+    if (!body) {
+        ++m_notFound;
+        replyStatus(socket, "404 Not Found");
+        return;
+    }
+    upload->body.reset(body);
+    ++m_uploads;
+    socket->write("HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: " +
+                  QByteArray::number(body->size()) + "\r\nConnection: close\r\n\r\n");
+
+    // 按套接字的发送进度分块读取，慢速的同伴不会让整个文件堆积在内存中
+    auto pump = [this, socket, upload]() {
+        if (upload->finished) return;
+        while (socket->bytesToWrite() < SEND_BUFFER && !upload->body->atEnd()) {
+            const QByteArray chunk = upload->body->read(SEND_CHUNK);
+            if (chunk.isEmpty()) break;
+            socket->write(chunk);
+            upload->sent += chunk.size();
+        }
+        if (upload->body->atEnd() && socket->bytesToWrite() == 0) {
+            upload->finished = true;
+            --m_uploads;
+            ++m_servedFiles;
+            m_servedBytes += upload->sent;
+            socket->disconnectFromHost();
+        }
+    };
+    QObject::connect(socket, &QTcpSocket::bytesWritten, socket, pump);
+    QObject::connect(socket, &QTcpSocket::disconnected, socket, [this, upload]() {
+        if (upload->finished) return;
+        upload->finished = true;            // 对方中途断开
+        --m_uploads;
+    });
+    pump();
+}
+
+void PeerShare::logStats(LogCategory category, const char *title) const {
+    ZDF_LOG_EVENT(category, L_INFO, "%1：向同伴提供 %2 个文件，%3 KB（%4）", title, m_servedFiles, m_servedBytes / 1024,
+                  QString("发现同伴 %1 个，未找到 %2 次，繁忙拒绝 %3 次").arg(m_peers.size()).arg(m_notFound).arg(m_busy));
+}
+
+// --------------------------- 考试程序共享资源包 ---------------------------
+static std::unique_ptr<PeerShare> s_packShare;
+
+void shareAssetPack(const AppConfig &config) {
+    AssetPack &pack = AssetPack::instance();
+    if (!config.peerShare.enabled || !pack.isOpen()) return;
+    s_packShare.reset(new PeerShare(config, pack.baseUrl(), [](const QString &path) -> QIODevice* {
+        zdfpack::Reader::Entry entry;
+        if (!AssetPack::instance().find(path.toUtf8(), entry)) return nullptr;
+        QBuffer *buffer = new QBuffer;
+        buffer->setData(entry.data);        // 引用映射内存，不复制
+        buffer->open(QIODevice::ReadOnly);
+        return buffer;
+    }));
+    s_packShare->setFileCount(pack.fileCount());
+    if (!s_packShare->start()) {
+        s_packShare.reset();
+        return;
+    }
+    // 套接字须在 QCoreApplication 销毁前关闭
+    QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, []() { s_packShare.reset(); });
+}
+
+void logAssetPackSharing(LogCategory category, const char *title) {
+    if (s_packShare) s_packShare->logStats(category, title);
+}
@@ -0,0 +1,101 @@
+#ifndef ZDF_PEERSHARE_H
+#define ZDF_PEERSHARE_H
+
+#include <QString>
+#include <QStringList>
+#include <QHostAddress>
+#include <QHash>
+#include <QUrl>
+#include <QElapsedTimer>
+
+#include <functional>
+#include <memory>
+
+#include "logger.h"
+
+class QIODevice;
+class QTcpServer;
+class QTcpSocket;
+class QUdpSocket;
+class QTimer;
+struct AppConfig;
+
+// --------------------------- 同伴共享 ---------------------------
+// 同一考场几十台终端通过同一台交换机从学校服务器下载相同的静态资源。启用 peerShare 后，
+// 每个实例在本网段组播通告自己持有的资源（基准地址和文件数），并通过一个只读的小型 HTTP
+// 服务把这些文件提供给邻近终端：GET /zdf-peer/<路径>，请求头 X-Zdf-Base 须与本机的基准地址一致。
+// 取用方按清单的 sha256 校验，不一致时改从下一个同伴或源站下载，因此不需要信任同伴。
+// 只在创建它的线程（事件循环）中使用
+struct PeerEndpoint {
+    QHostAddress address;
+    quint16 port;
+};
+
+class PeerShare {
+public:
+    // 按路径（相对基准地址，UTF-8 解码后）返回已打开的只读设备，没有该文件时返回 nullptr
+    using Source = std::function<QIODevice*(const QString &path)>;
+
+    static const char *const PATH_PREFIX;       // "/zdf-peer/"
+    static const char *const BASE_HEADER;       // "X-Zdf-Base"
+    static const int ANNOUNCE_MS = 3000;        // 通告间隔；超过三个间隔未再通告的同伴视为离开
+
+    PeerShare(const AppConfig &config, const QUrl &baseUrl, Source source);
+    ~PeerShare();
+
+    // 监听 HTTP 端口并开始收发通告；端口被占用等失败时记录原因并返回 false
+    bool start();
+    quint16 port() const;
+
+    // 通告中的文件数，取用方据此优先选择文件较全的同伴
+    void setFileCount(int count) { m_fileCount = count; }
+
+    // 最近通告过相同基准地址的同伴（不含本机），按文件数从多到少；其后是配置中的固定同伴
+    QList<PeerEndpoint> peers() const;
+
+    // 取用方请求同伴时使用的地址
+    static QUrl assetUrl(const PeerEndpoint &peer, const QString &path);
+
+    void logStats(LogCategory category, const char *title) const;
+
+private:
+    PeerShare(const PeerShare&)=delete; PeerShare& operator=(const PeerShare&)=delete;
+
+    struct Peer {
+        PeerEndpoint endpoint;
+        int files;
+        qint64 lastSeenMs;
+    };
+
+    struct Upload;
+
+    void announce();
+    void readAnnouncements();
+    void accept();
+    void respond(QTcpSocket *socket, const std::shared_ptr<Upload> &upload, const QByteArray &head);
+
+    const QUrl m_baseUrl;
+    const QString m_id;                 // 本实例标识，用于忽略自己的通告
+    const quint16 m_discoveryPort, m_listenPort;
+    const int m_maxUploads;
+    const QList<PeerEndpoint> m_fixedPeers;
+    Source m_source;
+
+    std::unique_ptr<QTcpServer> m_server;
+    std::unique_ptr<QUdpSocket> m_udp;
+    std::unique_ptr<QTimer> m_announceTimer;
+    QElapsedTimer m_clock;
+    QHash<QString, Peer> m_peers;       // 实例标识 → 最近一次通告
+    int m_fileCount = 0;
+    int m_uploads = 0;                  // 正在发送的连接数
+
+    int m_servedFiles = 0, m_notFound = 0, m_busy = 0;
+    qint64 m_servedBytes = 0;
+};
+
+// 考试程序：peerShare.enabled 且资源包已打开时，把资源包中的文件提供给同伴（映射内存直接发送）。
+// 在 installAssetPack 之后调用
+void shareAssetPack(const AppConfig &config);
+void logAssetPackSharing(LogCategory category, const char *title);
+
+#endif // ZDF_PEERSHARE_H
@@ -0,0 +1,326 @@
+#include "profile.h"
+#include "config.h"
+#include "logger.h"
+
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+
+#include <cmath>
+
+// --------------------------- 内置规则表 ---------------------------
+// 自上而下匹配，命中的规则依次叠加：后面的规则只需写与前面不同的部分。
+// when 中的条件全部满足才命中，写成数组时满足其中任意一组即可；省略 when 表示总是命中。
+static const char BUILTIN_RULES[] = R"JSON([
+{"name": "windows7",
+ "when": {"os": "win7"},
+ "env": {"QTWEBENGINE_DISABLE_GPU": "1", "QTWEBENGINE_DISABLE_SANDBOX": "1", "QT_OPENGL": "software"},
+ "chromiumFlags": ["--no-sandbox", "--disable-dev-shm-usage", "--disable-extensions", "--disable-plugins",
+                   "--max_old_space_size=256"],
+ "process": {"singleProcess": true},
+ "settings": {"webgl": false, "accelerated2dCanvas": false, "plugins": false, "javascriptCanOpenWindows": false}},
+
+{"name": "windows7-virtual",
+ "when": {"os": "win7", "virtualized": true},
+ "env": {"QTWEBENGINE_DISABLE_GPU_PROCESS": "1", "QTWEBENGINE_DISABLE_SOFTWARE_RASTERIZER": "1"}},
+
+{"name": "windows7-low",
+ "when": {"os": "win7", "lowResource": true},
+ "chromiumFlags": ["--max_old_space_size=128", "--disable-webgl", "--disable-accelerated-video-processing",
+                   "--disable-smooth-scrolling"],
+ "process": {"rendererProcessLimit": 1}},
+
+{"name": "windows7-virtual-low",
+ "when": {"os": "win7", "virtualized": true, "lowResource": true},
+ "chromiumFlags": ["--max_old_space_size=64", "--disable-webgl2", "--disable-3d-apis", "--use-gl=disabled",
+                   "--disable-gpu", "--disable-features=WebRTC", "--disable-background-networking",
+                   "--disable-renderer-backgrounding", "--memory-pressure-off",
+                   "--max-unused-resource-memory-usage-percentage=5"]},
+
+{"name": "linux-conservative",
+ "when": [{"os": "linux", "lowResource": true}, {"os": "linux", "virtualized": true}],
+ "chromiumFlags": ["--disable-dev-shm-usage", "--disable-extensions", "--disable-smooth-scrolling",
+                   "--disable-accelerated-video-decode"],
+ "process": {"rendererProcessLimit": 1},
+ "settings": {"webgl": false, "accelerated2dCanvas": false, "plugins": false}},
+
+{"name": "linux-low-memory",
+ "when": {"os": "linux", "lowMemory": true},
+ "chromiumFlags": ["--js-flags=--max-old-space-size=128", "--disable-background-networking"]},
+
+{"name": "linux-virtual",
+ "when": {"os": "linux", "virtualized": true},
+ "env": {"QT_XCB_FORCE_SOFTWARE_OPENGL": "1"},
+ "chromiumFlags": ["--disable-gpu", "--disable-webgl"]},
+
+{"name": "progressive-virtual",
+ "when": {"virtualized": true, "profile": ["low", "standard"]},
+ "loading": {"progressive": true}},
+
+{"name": "progressive-low",
+ "when": {"lowResource": true},
+ "loading": {"progressive": true, "delayMs": 15000}},
+
+{"name": "progressive-virtual-low",
+ "when": {"virtualized": true, "lowResource": true},
+ "loading": {"delayMs": 30000}},
+
+{"name": "virtual-timers",
+ "when": {"virtualized": true},
+ "timers": {"maintenanceMs": 20000, "focusCheckTicks": 12, "fullscreenCheckTicks": 12, "memoryCheckTicks": 120}}
+])JSON";
+
+// --------------------------- 字段表 ---------------------------
+// 规则中 process/settings/loading/timers 四节的字段与 PerformanceProfile 成员一一对应
+struct BoolField { const char *section; const char *key; bool PerformanceProfile::*member; };
+struct IntField { const char *section; const char *key; int PerformanceProfile::*member; int minValue; int maxValue; };
+
+static const BoolField BOOL_FIELDS[] = {
+    {"process",  "singleProcess",            &PerformanceProfile::singleProcess},
+    {"settings", "webgl",                    &PerformanceProfile::webgl},
+    {"settings", "accelerated2dCanvas",      &PerformanceProfile::accelerated2dCanvas},
+    {"settings", "plugins",                  &PerformanceProfile::plugins},
+    {"settings", "javascriptCanOpenWindows", &PerformanceProfile::javascriptCanOpenWindows},
+    {"loading",  "progressive",              &PerformanceProfile::progressiveLoading},
+    {"loading",  "onReady",                  &PerformanceProfile::loadOnReady},
+};
+
+static const IntField INT_FIELDS[] = {
+    {"process", "rendererProcessLimit", &PerformanceProfile::rendererProcessLimit,  0, 64},
+    {"loading", "delayMs",              &PerformanceProfile::loadDelayMs,           0, 120000},
+    {"loading", "minFreeMemoryMB",      &PerformanceProfile::loadMinFreeMemoryMB,   0, 65536},
+    {"timers",  "maintenanceMs",        &PerformanceProfile::maintenanceIntervalMs, 1000, 600000},
+    {"timers",  "focusCheckTicks",      &PerformanceProfile::focusCheckTicks,       1, 10000},
+    {"timers",  "fullscreenCheckTicks", &PerformanceProfile::fullscreenCheckTicks,  1, 10000},
+    {"timers",  "memoryCheckTicks",     &PerformanceProfile::memoryCheckTicks,      1, 10000},
+};
+
+static const char *const SECTIONS[] = {"process", "settings", "loading", "timers"};
+
+// --------------------------- 参数合并 ---------------------------
+static QString flagKey(const QString &flag) {
+    const int eq = flag.indexOf('=');
+    return eq < 0 ? flag : flag.left(eq);
+}
+
+// 同名参数原位替换；以 "!" 开头表示删除前面规则加入的同名参数
+static void mergeFlag(QStringList &flags, const QString &flag) {
+    const bool remove = flag.startsWith('!');
+    const QString value = remove ? flag.mid(1) : flag;
+    const QString key = flagKey(value);
+    for (int i = 0; i < flags.size(); ++i) {
+        if (flagKey(flags.at(i)) != key) continue;
+        if (remove) flags.removeAt(i);
+        else flags[i] = value;
+        return;
+    }
+    if (!remove) flags << value;
+}
+
+QByteArray PerformanceProfile::chromiumFlagsValue() const {
+    QStringList flags = chromiumFlags;
+    if (singleProcess) mergeFlag(flags, "--single-process");
+    if (rendererProcessLimit > 0) mergeFlag(flags, QString("--renderer-process-limit=%1").arg(rendererProcessLimit));
+    return flags.join(' ').toLocal8Bit();
+}
+
+// --------------------------- 规则匹配 ---------------------------
+static bool matchesName(const QJsonValue &v, const QStringList &actual) {
+    if (v.isString()) return v.toString() == "any" || actual.contains(v.toString());
+    if (v.isArray()) {
+        for (const QJsonValue &item : v.toArray())
+            if (matchesName(item, actual)) return true;
+    }
+    return false;
+}
+
+static bool matchesCondition(const QJsonObject &when, const SystemInfo &info,
+                             const QString &rule, QStringList &warnings) {
+    QStringList os;
+#if defined(Q_OS_WIN)
+    os << "windows";
+    if (info.isOldWin) os << "win7";
+#elif defined(Q_OS_LINUX)
+    os << "linux";
+#else
+    os << "other";
+#endif
+    static const char *const PROFILE_KEYS[] = {"low", "standard", "high"};
+    const bool lowResource = info.lowMemory || info.isOldCpu;
+
+    for (auto it = when.constBegin(); it != when.constEnd(); ++it) {
+        const QString &key = it.key();
+        const QJsonValue v = it.value();
+        bool flag = false;
+        if (key == "os") {
+            if (!matchesName(v, os)) return false;
+            continue;
+        }
+        if (key == "profile") {
+            if (!matchesName(v, QStringList(QString::fromLatin1(PROFILE_KEYS[info.profile])))) return false;
+            continue;
+        }
+        if (key == "virtualized") flag = info.isVirtualized;
+        else if (key == "lowMemory") flag = info.lowMemory;
+        else if (key == "oldCpu") flag = info.isOldCpu;
+        else if (key == "lowResource") flag = lowResource;
+        else {
+            warnings << QString("规则 %1：未知条件 when.%2，该规则不生效").arg(rule, key);
+            return false;
+        }
+        if (!v.isBool()) {
+            warnings << QString("规则 %1：when.%2 应为 true/false，该规则不生效").arg(rule, key);
+            return false;
+        }
+        if (v.toBool() != flag) return false;
+    }
+    return true;
+}
+
+static bool ruleMatches(const QJsonValue &when, const SystemInfo &info,
+                        const QString &rule, QStringList &warnings) {
+    if (when.isUndefined() || when.isNull()) return true;
+    if (when.isObject()) return matchesCondition(when.toObject(), info, rule, warnings);
+    if (when.isArray()) {
+        for (const QJsonValue &alt : when.toArray()) {
+            if (alt.isObject() && matchesCondition(alt.toObject(), info, rule, warnings)) return true;
+        }
+        return false;
+    }
+    warnings << QString("规则 %1：when 应为对象或对象数组，该规则不生效").arg(rule);
+    return false;
+}
+
+// --------------------------- 规则应用 ---------------------------
+static void applySection(PerformanceProfile &p, const QJsonObject &section, const char *name,
+                         const QString &rule, QStringList &changes) {
+    for (auto it = section.constBegin(); it != section.constEnd(); ++it) {
+        const QString field = QString("%1.%2").arg(QLatin1String(name), it.key());
+        bool known = false;
+        for (const BoolField &f : BOOL_FIELDS) {
+            if (qstrcmp(f.section, name) != 0 || it.key() != QLatin1String(f.key)) continue;
+            known = true;
+            if (!it.value().isBool()) {
+                p.warnings << QString("规则 %1：%2 应为 true/false，已忽略").arg(rule, field);
+                break;
+            }
+            p.*f.member = it.value().toBool();
+            changes << QString("%1=%2").arg(field, it.value().toBool() ? "true" : "false");
+        }
+        for (const IntField &f : INT_FIELDS) {
+            if (qstrcmp(f.section, name) != 0 || it.key() != QLatin1String(f.key)) continue;
+            known = true;
+            const double d = it.value().toDouble();
+            if (!it.value().isDouble() || d != std::floor(d) || d < f.minValue || d > f.maxValue) {
+                p.warnings << QString("规则 %1：%2 应为 %3~%4 的整数，已忽略")
+                              .arg(rule, field).arg(f.minValue).arg(f.maxValue);
+                break;
+            }
+            p.*f.member = int(d);
+            changes << QString("%1=%2").arg(field).arg(int(d));
+        }
+        if (!known) p.warnings << QString("规则 %1：未知字段 %2，已忽略").arg(rule, field);
+    }
+}
+
+static void applyRule(PerformanceProfile &p, const QJsonObject &rule, const QString &name) {
+    QStringList changes;
+    for (auto it = rule.constBegin(); it != rule.constEnd(); ++it) {
+        const QString &key = it.key();
+        if (key == "name" || key == "when") continue;
+        if (key == "env") {
+            const QJsonObject env = it.value().toObject();
+            for (auto e = env.constBegin(); e != env.constEnd(); ++e) {
+                p.environment.insert(e.key().toLatin1(), e.value().toString().toLocal8Bit());
+                changes << QString("env %1=%2").arg(e.key(), e.value().toString());
+            }
+        } else if (key == "chromiumFlags") {
+            for (const QJsonValue &flag : it.value().toArray()) {
+                if (!flag.isString()) continue;
+                mergeFlag(p.chromiumFlags, flag.toString());
+                changes << flag.toString();
+            }
+        } else {
+            bool section = false;
+            for (const char *s : SECTIONS) {
+                if (key != QLatin1String(s)) continue;
+                section = true;
+                applySection(p, it.value().toObject(), s, name, changes);
+            }
+            if (!section) p.warnings << QString("规则 %1：未知字段 %2，已忽略").arg(name, key);
+        }
+    }
+    p.rules << name;
+    p.decisions << QString("%1：%2").arg(name, changes.isEmpty() ? QString("无改动") : changes.join(' '));
+}
+
+static const QJsonArray &builtinRules() {
+    static const QJsonArray rules = QJsonDocument::fromJson(QByteArray(BUILTIN_RULES)).array();
+    return rules;
+}
+
+static void applyRules(PerformanceProfile &p, const QJsonArray &rules, const char *origin,
+                       const SystemInfo &info) {
+    for (int i = 0; i < rules.size(); ++i) {
+        const QJsonObject rule = rules.at(i).toObject();
+        const QString name = rule.value("name").toString(QString("%1#%2").arg(QLatin1String(origin)).arg(i + 1));
+        if (ruleMatches(rule.value("when"), info, name, p.warnings)) applyRule(p, rule, name);
+    }
+}
+
+PerformanceProfile resolvePerformanceProfile(const SystemInfo &info, const AppConfig *config) {
+    PerformanceProfile p;
+    const AppConfig defaults;
+    const AppConfig &conf = config ? *config : defaults;
+    p.loadDelayMs = conf.lowMemory.progressiveLoadingDelayMs;
+
+    if (!conf.profiles.replaceBuiltin) applyRules(p, builtinRules(), "内置", info);
+    applyRules(p, conf.profiles.rules, "配置", info);
+
+    // 配置文件显式关闭硬件加速时优先于规则表
+    if (conf.disableHardwareAcceleration) {
+        p.webgl = p.accelerated2dCanvas = false;
+        p.decisions << "配置 disableHardwareAcceleration：settings.webgl=false settings.accelerated2dCanvas=false";
+    }
+    return p;
+}
+
+// --------------------------- 应用与日志 ---------------------------
+void applyProfileEnvironment(const PerformanceProfile &profile) {
+    static const QByteArray external = qgetenv("QTWEBENGINE_CHROMIUM_FLAGS");   // 外部已设置的参数保留在前
+    const bool platformCreated = QCoreApplication::instance() != nullptr;
+
+    for (auto it = profile.environment.constBegin(); it != profile.environment.constEnd(); ++it) {
+        if (platformCreated && it.key().startsWith("QT_") && qgetenv(it.key().constData()) != it.value())
+            ZDF_LOG_EVENT(CatStartup, L_WARNING, "环境变量 %1 须在 QApplication 创建前设置，本次启动未生效",
+                          QString::fromLatin1(it.key()));
+        qputenv(it.key().constData(), it.value());
+    }
+
+    const QByteArray flags = (external + ' ' + profile.chromiumFlagsValue()).trimmed();
+    if (flags.isEmpty()) qunsetenv("QTWEBENGINE_CHROMIUM_FLAGS");
+    else qputenv("QTWEBENGINE_CHROMIUM_FLAGS", flags);
+}
+
+void logPerformanceProfile(const PerformanceProfile &profile) {
+    ZDF_LOG_EVENT(CatStartup, L_INFO, "性能档案：命中规则 %1",
+                  profile.rules.isEmpty() ? QString("无（全部取默认值）") : profile.rules.join(" → "));
+    for (const QString &decision : profile.decisions)
+        ZDF_LOG_EVENT(CatStartup, L_INFO, "性能档案决定 - %1", decision);
+    for (const QString &warning : profile.warnings)
+        ZDF_LOG_EVENT(CatStartup, L_WARNING, "性能档案：%1", warning);
+
+    ZDF_LOG_EVENT(CatStartup, L_INFO, "Chromium 参数：%1",
+                  QString::fromLocal8Bit(qgetenv("QTWEBENGINE_CHROMIUM_FLAGS")));
+    ZDF_LOG_EVENT(CatStartup, L_INFO, "WebEngine 设置：WebGL %1，2D 加速 %2，插件 %3，脚本打开窗口 %4",
+                  profile.webgl, profile.accelerated2dCanvas, profile.plugins, profile.javascriptCanOpenWindows);
+    ZDF_LOG_EVENT(CatStartup, L_INFO, "加载策略：%1，维护间隔 %2 ms，焦点/全屏/内存检查每 %3/%4/%5 次",
+                  !profile.progressiveLoading ? QString("直接加载")
+                  : profile.loadOnReady ? QString("渐进式（就绪即加载，最长 %1 ms，可用内存不低于 %2MB）")
+                                          .arg(profile.loadDelayMs).arg(profile.loadMinFreeMemoryMB)
+                  : QString("渐进式（固定延迟 %1 ms）").arg(profile.loadDelayMs),
+                  profile.maintenanceIntervalMs, profile.focusCheckTicks,
+                  profile.fullscreenCheckTicks, profile.memoryCheckTicks);
+}
@@ -0,0 +1,57 @@
+#ifndef ZDF_PROFILE_H
+#define ZDF_PROFILE_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QMap>
+
+#include "sysinfo.h"
+
+struct AppConfig;
+
+// --------------------------- 性能档案 ---------------------------
+// 由规则表按系统信息逐条匹配得到的完整设置：Chromium 参数、环境变量、QWebEngineSettings、
+// 进程限制、维护定时器和加载策略。规则表内置于程序，可由 config.json 的 performanceProfiles 覆盖
+struct PerformanceProfile {
+    QStringList rules;                          // 命中的规则名，按匹配顺序
+
+    QMap<QByteArray, QByteArray> environment;
+    QStringList chromiumFlags;                  // 同名参数（"=" 之前相同）后者覆盖前者
+    bool singleProcess = false;
+    int rendererProcessLimit = 0;               // 0 表示不限制
+
+    bool webgl = true;
+    bool accelerated2dCanvas = true;
+    bool plugins = true;
+    bool javascriptCanOpenWindows = true;
+
+    bool progressiveLoading = false;
+    int loadDelayMs = 3000;                     // 等待就绪的上限；loadOnReady 为 false 时固定等待该时长
+    bool loadOnReady = true;                    // 加载页完成、渲染进程响应且内存充足后立即打开考试页面
+    int loadMinFreeMemoryMB = 200;
+
+    int maintenanceIntervalMs = 10000;          // 配置文件 maintenance.intervalMs 优先
+    int focusCheckTicks = 6;                    // 以下均为“每 N 次维护定时器触发检查一次”
+    int fullscreenCheckTicks = 6;
+    int memoryCheckTicks = 60;
+
+    QStringList decisions;                      // 每条命中规则改动了哪些设置，写入 startup.log
+    QStringList warnings;                       // 规则中无法识别的条件或字段
+
+    // 最终的 QTWEBENGINE_CHROMIUM_FLAGS（不含外部已设置的部分）
+    QByteArray chromiumFlagsValue() const;
+};
+
+// 依次匹配内置规则和配置文件中的规则，命中的规则按顺序叠加。
+// config 为空时只用内置规则（QApplication 创建前配置尚未加载）
+PerformanceProfile resolvePerformanceProfile(const SystemInfo &info, const AppConfig *config = nullptr);
+
+// 写入环境变量和 Chromium 参数，须在首个 QWebEngineView 创建前调用；
+// QT_ 开头的平台变量须在 QApplication 创建前调用才能生效
+void applyProfileEnvironment(const PerformanceProfile &profile);
+
+// 命中的规则和每项决定写入 startup.log，便于按机型汇总后调整规则
+void logPerformanceProfile(const PerformanceProfile &profile);
+
+#endif // ZDF_PROFILE_H
@@ -0,0 +1,308 @@
+#include "reqtiming.h"
+#include "config.h"
+
+#include <QCoreApplication>
+#include <QWebEngineProfile>
+#include <QWebEngineScript>
+#include <QWebEngineScriptCollection>
+#include <QWebEnginePage>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <cmath>
+
+// --------------------------- 页面脚本 ---------------------------
+// 每条记录：[地址, 发起类型, 开始, 总耗时, 排队, DNS, 连接, TLS, 等待服务器, 下载, 传输字节, 响应体字节, 协议]，
+// 时间为相对页面时间原点的毫秒。requestStart 为 0 表示跨域且未返回 Timing-Allow-Origin，分段记为 -1。
+// 两次取回之间最多缓存 1000 条，超出的只计数。
+// 旧版 Chromium（Qt 5.9）不支持 navigation 条目，页面 load 后改由 performance.timing 补一条主页面记录
+static const char *const TIMING_SCRIPT = R"JS(
+(function () {
+    if (window.__zdfTiming || !window.PerformanceObserver) return;
+    var t = window.__zdfTiming = {e: [], d: 0, p: null};
+    function ms(v) { return v < 0 ? -1 : Math.round(v * 10) / 10; }
+    function add(e, type) {
+        if (t.e.length >= 1000) { t.d++; return; }
+        var timed = e.requestStart > 0;
+        var dns = timed ? e.domainLookupEnd - e.domainLookupStart : -1;
+        var connect = timed ? e.connectEnd - e.connectStart : -1;
+        var ssl = timed && e.secureConnectionStart > 0 ? e.connectEnd - e.secureConnectionStart : -1;
+        var blocked = timed ? Math.max(0, e.requestStart - e.startTime - dns - connect) : -1;
+        t.e.push([e.name, type, ms(e.startTime), ms(e.duration), ms(blocked), ms(dns), ms(connect), ms(ssl),
+                  timed ? ms(e.responseStart - e.requestStart) : -1, timed ? ms(e.responseEnd - e.responseStart) : -1,
+                  e.transferSize || 0, e.encodedBodySize || 0, e.nextHopProtocol || '']);
+    }
+    new PerformanceObserver(function (list) {
+        list.getEntries().forEach(function (e) {
+            if (e.entryType === 'navigation') t.p = [ms(e.domContentLoadedEventEnd), ms(e.loadEventEnd)];
+            add(e, e.initiatorType || e.entryType);
+        });
+    }).observe({entryTypes: ['resource', 'navigation']});
+    window.addEventListener('load', function () {
+        setTimeout(function () {
+            if (t.p || !performance.timing) return;
+            var n = performance.timing, s = n.navigationStart;
+            t.p = [n.domContentLoadedEventEnd - s, n.loadEventEnd - s];
+            add({name: location.href, startTime: 0, duration: n.responseEnd - s,
+                 domainLookupStart: n.domainLookupStart - s, domainLookupEnd: n.domainLookupEnd - s,
+                 connectStart: n.connectStart - s, connectEnd: n.connectEnd - s,
+                 secureConnectionStart: n.secureConnectionStart ? n.secureConnectionStart - s : 0,
+                 requestStart: n.requestStart - s, responseStart: n.responseStart - s,
+                 responseEnd: n.responseEnd - s}, 'navigation');
+        }, 0);
+    });
+})();
+)JS";
+
+static const char *const COLLECT_SCRIPT =
+    "(function(){var t=window.__zdfTiming;if(!t)return null;"
+    "var r={o:performance.timeOrigin||performance.timing.navigationStart,u:location.href,e:t.e,d:t.d,p:t.p};"
+    "t.e=[];t.d=0;return r;})()";
+
+enum TimingField { FUrl, FType, FStart, FTotal, FBlocked, FDns, FConnect, FSsl, FWait, FReceive,
+                   FTransfer, FBody, FProtocol, FieldCount };
+
+// --------------------------- 采集 ---------------------------
+const int RequestTiming::BUCKET_BOUNDS[BUCKETS - 1] = {10, 25, 50, 100, 250, 500, 1000, 2500, 5000};
+
+void RequestTiming::attach(QWebEngineProfile *profile, const AppConfig &config) {
+    if (!config.requestTiming.enabled) return;
+    QWebEngineScript script;
+    script.setName("zdf-request-timing");
+    script.setSourceCode(QString::fromLatin1(TIMING_SCRIPT));
+    script.setInjectionPoint(QWebEngineScript::DocumentCreation);
+    script.setWorldId(QWebEngineScript::ApplicationWorld);
+    script.setRunsOnSubFrames(false);
+    profile->scripts()->insert(script);
+    m_attached.store(true, std::memory_order_relaxed);
+}
+
+void RequestTiming::noteRequest(const QUrl &url) {
+    if (!isAttached()) return;
+    QMutexLocker lock(&m_nativeMutex);
+    ++m_nativeRequests[url.host()];
+}
+
+void RequestTiming::collect(QWebEnginePage *page, const std::function<void()> &done) {
+    if (!isAttached()) {
+        if (done) done();
+        return;
+    }
+    page->runJavaScript(QString::fromLatin1(COLLECT_SCRIPT), QWebEngineScript::ApplicationWorld,
+                        [this, done](const QVariant &result) {
+        if (result.type() == QVariant::Map) addEntries(result.toMap());
+        if (done) done();
+    });
+}
+
+void RequestTiming::pageLoadStarted() {
+    m_loadTimer.start();
+}
+
+void RequestTiming::pageLoadFinished(QWebEnginePage *page, bool ok, const std::function<void()> &done) {
+    const qint64 windowLoadMs = m_loadTimer.isValid() ? m_loadTimer.elapsed() : -1;
+    m_loadTimer.invalidate();
+    const int previous = m_lastPage;
+    collect(page, [this, previous, windowLoadMs, ok, done]() {
+        // 取回的若是新页面（或页面脚本未运行），不把加载时间记到上一个页面上
+        if (m_lastPage >= 0 && (m_lastPage != previous || m_pages[size_t(m_lastPage)].windowLoadMs < 0)) {
+            m_pages[size_t(m_lastPage)].windowLoadMs = windowLoadMs;
+            m_pages[size_t(m_lastPage)].ok = ok;
+        }
+        if (done) done();
+    });
+}
+
+int RequestTiming::pageFor(double originMs, const QString &url) {
+    for (int i = int(m_pages.size()) - 1; i >= 0; --i)
+        if (m_pages[size_t(i)].originMs == originMs) return i;
+    Page page;
+    page.url = url;
+    page.originMs = originMs;
+    m_pages.push_back(page);
+    return int(m_pages.size()) - 1;
+}
+
+void RequestTiming::addEntries(const QVariantMap &result) {
+    const double originMs = result.value("o").toDouble();
+    const int pageIndex = pageFor(originMs, result.value("u").toString());
+    m_lastPage = pageIndex;
+    const QVariantList timings = result.value("p").toList();
+    if (timings.size() == 2) {
+        Page &page = m_pages[size_t(pageIndex)];
+        page.contentLoadMs = timings.at(0).toDouble() > 0 ? timings.at(0).toDouble() : -1;
+        page.loadMs = timings.at(1).toDouble() > 0 ? timings.at(1).toDouble() : -1;
+    }
+    m_dropped += result.value("d").toLongLong();
+
+    const int maxEntries = ConfigManager::instance().snapshot().requestTiming.maxEntries;
+    for (const QVariant &v : result.value("e").toList()) {
+        const QVariantList f = v.toList();
+        if (f.size() != FieldCount) continue;
+        Entry e;
+        e.page = pageIndex;
+        e.startedMs = originMs + f.at(FStart).toDouble();
+        e.url = f.at(FUrl).toString();
+        e.initiator = f.at(FType).toString();
+        e.protocol = f.at(FProtocol).toString();
+        e.total = f.at(FTotal).toDouble();
+        e.blocked = f.at(FBlocked).toDouble();
+        e.dns = f.at(FDns).toDouble();
+        e.connect = f.at(FConnect).toDouble();
+        e.ssl = f.at(FSsl).toDouble();
+        e.wait = f.at(FWait).toDouble();
+        e.receive = f.at(FReceive).toDouble();
+        e.transferSize = f.at(FTransfer).toLongLong();
+        e.bodySize = f.at(FBody).toLongLong();
+
+        const QString host = QUrl(e.url).host();
+        HostStats &h = m_hosts[host.isEmpty() ? QString("(无主机)") : host];
+        ++h.requests;
+        ++h.total[size_t(bucketOf(e.total))];
+        h.transferBytes += e.transferSize;
+        if (e.wait >= 0) {
+            ++h.timed;
+            ++h.wait[size_t(bucketOf(e.wait))];
+            h.waitMs += e.wait;
+            h.blockedMs += e.blocked;
+            h.networkMs += std::max(e.dns, 0.0) + std::max(e.connect, 0.0) + std::max(e.receive, 0.0);
+        }
+
+        m_entries.push_back(std::move(e));
+        while (int(m_entries.size()) > maxEntries) {
+            m_entries.pop_front();
+            ++m_dropped;
+        }
+    }
+}
+
+// --------------------------- 汇总与导出 ---------------------------
+int RequestTiming::bucketOf(double ms) {
+    return int(std::upper_bound(std::begin(BUCKET_BOUNDS), std::end(BUCKET_BOUNDS), ms - 1e-9) - std::begin(BUCKET_BOUNDS));
+}
+
+// 直方图只能给出所在档的上界
+QString RequestTiming::percentile(const std::array<int, BUCKETS> &histogram, int count, int percent) {
+    const int target = std::max(1, int(std::ceil(count * percent / 100.0)));
+    int cumulative = 0;
+    for (int i = 0; i < BUCKETS - 1; ++i) {
+        cumulative += histogram[size_t(i)];
+        if (cumulative >= target) return QString("≤%1").arg(BUCKET_BOUNDS[i]);
+    }
+    return QString(">%1").arg(BUCKET_BOUNDS[BUCKETS - 2]);
+}
+
+void RequestTiming::logSummary(LogCategory category, const char *title) const {
+    if (!isAttached()) return;
+    if (m_hosts.isEmpty()) {
+        ZDF_LOG_EVENT(category, L_INFO, "%1：没有请求计时记录", title);
+        return;
+    }
+    QHash<QString, int> native;
+    {
+        QMutexLocker lock(&m_nativeMutex);
+        native = m_nativeRequests;
+    }
+    static const int SHOWN = 8;
+    QStringList hosts = m_hosts.keys();
+    std::sort(hosts.begin(), hosts.end(), [this](const QString &a, const QString &b) {
+        const int ra = m_hosts.value(a).requests, rb = m_hosts.value(b).requests;
+        return ra != rb ? ra > rb : a < b;
+    });
+    for (int i = 0; i < hosts.size() && i < SHOWN; ++i) {
+        const HostStats h = m_hosts.value(hosts.at(i));
+        QString detail = QString("请求 %1 个（浏览器发出 %2），总耗时 p50 %3 / p90 %4 ms")
+            .arg(h.requests).arg(native.value(hosts.at(i)))
+            .arg(percentile(h.total, h.requests, 50), percentile(h.total, h.requests, 90));
+        if (h.timed > 0)
+            detail += QString("；%1 个有分段计时：等待服务器 p50 %2 / p90 %3 ms，平均排队 %4 ms、网络 %5 ms")
+                .arg(h.timed).arg(percentile(h.wait, h.timed, 50), percentile(h.wait, h.timed, 90))
+                .arg(qRound(h.blockedMs / h.timed)).arg(qRound(h.networkMs / h.timed));
+        else
+            detail += QString("；无分段计时（跨域且未返回 Timing-Allow-Origin）");
+        ZDF_LOG_EVENT(category, L_INFO, "%1 %2：%3", title, hosts.at(i), detail);
+    }
+    if (hosts.size() > SHOWN)
+        ZDF_LOG_EVENT(category, L_INFO, "%1：另有 %2 个主机未列出", title, hosts.size() - SHOWN);
+    if (m_lastPage >= 0) {
+        const Page &p = m_pages[size_t(m_lastPage)];
+        ZDF_LOG_EVENT(category, L_INFO, "%1 页面 %2：%3", title, p.url,
+                      QString("DOMContentLoaded %1 ms，load %2 ms，窗口加载 %3 ms%4")
+                      .arg(qRound(p.contentLoadMs)).arg(qRound(p.loadMs)).arg(p.windowLoadMs)
+                      .arg(p.ok ? "" : "（加载失败）"));
+    }
+}
+
+static QString isoTime(double msSinceEpoch) {
+    return QDateTime::fromMSecsSinceEpoch(qint64(msSinceEpoch)).toUTC().toString(Qt::ISODateWithMs);
+}
+
+static QString httpVersion(const QString &protocol) {
+    if (protocol == "h2") return "HTTP/2";
+    if (protocol.startsWith("http/")) return protocol.toUpper();
+    return protocol;
+}
+
+// HAR 1.2 的结构；Resource Timing 不提供请求方法、状态码和头部，分别填 GET、0 和空表，
+// 无分段计时的记录整段计入 wait，并以 _timingAllowed 标明
+QString RequestTiming::exportHar(const char *reason) const {
+    if (!isAttached() || !Logger::instance().ensureLogDirectoryExists()) return QString();
+    const QString path = Logger::instance().logDirectory() +
+                         QDateTime::currentDateTime().toString("'/requests-'yyyyMMdd-HHmmss'.har'");
+
+    QJsonArray pages;
+    for (size_t i = 0; i < m_pages.size(); ++i) {
+        const Page &p = m_pages[i];
+        pages.append(QJsonObject{
+            {"startedDateTime", isoTime(p.originMs)}, {"id", QString("page_%1").arg(i + 1)}, {"title", p.url},
+            {"pageTimings", QJsonObject{{"onContentLoad", p.contentLoadMs}, {"onLoad", p.loadMs}}},
+            {"_windowLoadMs", double(p.windowLoadMs)}, {"_loadOk", p.ok}});
+    }
+    QJsonArray entries;
+    for (const Entry &e : m_entries) {
+        const bool timed = e.wait >= 0;
+        const QString version = httpVersion(e.protocol);
+        entries.append(QJsonObject{
+            {"pageref", QString("page_%1").arg(e.page + 1)},
+            {"startedDateTime", isoTime(e.startedMs)},
+            {"time", e.total},
+            {"request", QJsonObject{{"method", "GET"}, {"url", e.url}, {"httpVersion", version},
+                                    {"headers", QJsonArray()}, {"queryString", QJsonArray()},
+                                    {"cookies", QJsonArray()}, {"headersSize", -1}, {"bodySize", -1}}},
+            {"response", QJsonObject{{"status", 0}, {"statusText", ""}, {"httpVersion", version},
+                                     {"headers", QJsonArray()}, {"cookies", QJsonArray()},
+                                     {"content", QJsonObject{{"size", double(e.bodySize)}, {"mimeType", ""}}},
+                                     {"redirectURL", ""}, {"headersSize", -1}, {"bodySize", double(e.bodySize)}}},
+            {"cache", QJsonObject()},
+            {"timings", QJsonObject{{"blocked", e.blocked}, {"dns", e.dns}, {"connect", e.connect},
+                                    {"ssl", e.ssl}, {"send", 0}, {"wait", timed ? e.wait : e.total},
+                                    {"receive", timed ? e.receive : 0}}},
+            {"_initiatorType", e.initiator}, {"_transferSize", double(e.transferSize)}, {"_timingAllowed", timed}});
+    }
+    const QJsonObject log{
+        {"version", "1.2"},
+        {"creator", QJsonObject{{"name", QCoreApplication::applicationName()},
+                                {"version", QCoreApplication::applicationVersion()}}},
+        {"comment", QString("%1；早于最近 %2 条的记录已丢弃 %3 条").arg(QString::fromUtf8(reason))
+                    .arg(m_entries.size()).arg(m_dropped)},
+        {"pages", pages},
+        {"entries", entries}};
+
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) {
+        ZDF_LOG_EVENT(CatNet, L_WARNING, "请求计时无法导出：%1（%2）", path, f.errorString());
+        return QString();
+    }
+    f.write(QJsonDocument(QJsonObject{{"log", log}}).toJson(QJsonDocument::Compact));
+    if (!f.commit()) {
+        ZDF_LOG_EVENT(CatNet, L_WARNING, "请求计时无法导出：%1（%2）", path, f.errorString());
+        return QString();
+    }
+    ZDF_LOG_EVENT(CatNet, L_INFO, "请求计时已导出（%1）：%2，%3 条记录", reason, path, int(m_entries.size()));
+    return path;
+}
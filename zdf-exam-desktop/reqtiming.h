@@ -0,0 +1,100 @@
+#ifndef ZDF_REQTIMING_H
+#define ZDF_REQTIMING_H
+
+#include <QString>
+#include <QHash>
+#include <QMutex>
+#include <QUrl>
+#include <QElapsedTimer>
+#include <QVariant>
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "logger.h"
+
+class QWebEngineProfile;
+class QWebEnginePage;
+struct AppConfig;
+
+// --------------------------- 请求计时 ---------------------------
+// 学生反映“考试很卡”时，用来区分是服务器慢还是本机/网络慢：
+// - 页面中注入的脚本（独立的 JavaScript 环境）按 Resource Timing / Navigation Timing 记录主页面和
+//   每个子资源的分段耗时：排队、DNS、连接、等待服务器（请求发出到首字节）、下载
+// - 程序侧由请求拦截器统计浏览器实际发出的请求数，由加载信号记录页面从开始加载到完成的时间
+// 汇总为按主机的耗时直方图写入日志；明细保留最近 requestTiming.maxEntries 条，可导出为 HAR 文件。
+// noteRequest 由请求拦截器调用：Qt 5.13 起在 GUI 线程，更早的版本在 WebEngine 的 IO 线程，
+// 因此按主机的请求计数仍由 m_nativeMutex 保护；其余只在 GUI 线程调用
+class RequestTiming {
+public:
+    static RequestTiming& instance(){ static RequestTiming t; return t; }
+
+    // 按 requestTiming.enabled 向 profile 注入计时脚本，须在首个页面创建前调用
+    void attach(QWebEngineProfile *profile, const AppConfig &config);
+    bool isAttached() const { return m_attached.load(std::memory_order_relaxed); }
+
+    void noteRequest(const QUrl &url);
+
+    // 取回页面中累计的计时记录（异步），取回后调用 done；未启用时直接调用 done
+    void collect(QWebEnginePage *page, const std::function<void()> &done = std::function<void()>());
+
+    // 主页面加载信号：记录程序侧看到的加载时间，完成时一并取回计时记录
+    void pageLoadStarted();
+    void pageLoadFinished(QWebEnginePage *page, bool ok, const std::function<void()> &done = std::function<void()>());
+
+    // 按主机写出耗时分布（请求最多的几个主机）和最近一个页面的加载时间
+    void logSummary(LogCategory category, const char *title) const;
+
+    // 在日志目录下写出 HAR 文件，返回文件路径，失败时返回空
+    QString exportHar(const char *reason) const;
+
+private:
+    RequestTiming() = default;
+    RequestTiming(const RequestTiming&)=delete; RequestTiming& operator=(const RequestTiming&)=delete;
+
+    // 直方图上界（毫秒），最后一档为超过 5 秒
+    static const int BUCKETS = 10;
+    static const int BUCKET_BOUNDS[BUCKETS - 1];
+
+    struct Entry {
+        int page;
+        double startedMs;               // 相对 1970 年的毫秒
+        QString url, initiator, protocol;
+        double total, blocked, dns, connect, ssl, wait, receive;    // 毫秒，-1 表示无法获得
+        qint64 transferSize, bodySize;
+    };
+    struct Page {
+        QString url;
+        double originMs;                // 页面的 performance.timeOrigin，用于识别同一页面
+        double contentLoadMs{-1}, loadMs{-1};
+        qint64 windowLoadMs{-1};        // 程序侧 loadStarted 到 loadFinished
+        bool ok{true};
+    };
+    struct HostStats {
+        int requests{0}, timed{0};      // timed：有分段计时（同源或服务器返回了 Timing-Allow-Origin）
+        std::array<int, BUCKETS> total{}, wait{};
+        double blockedMs{0}, networkMs{0}, waitMs{0};
+        qint64 transferBytes{0};
+    };
+
+    static int bucketOf(double ms);
+    static QString percentile(const std::array<int, BUCKETS> &histogram, int count, int percent);
+    int pageFor(double originMs, const QString &url);
+    void addEntries(const QVariantMap &result);
+
+    std::atomic<bool> m_attached{false};
+    mutable QMutex m_nativeMutex;
+    QHash<QString, int> m_nativeRequests;       // 拦截器看到的请求数，按主机
+
+    std::vector<Page> m_pages;
+    std::deque<Entry> m_entries;
+    QHash<QString, HostStats> m_hosts;
+    qint64 m_dropped{0};                        // 超出上限被丢弃的明细
+    int m_lastPage{-1};
+    QElapsedTimer m_loadTimer;
+};
+
+#endif // ZDF_REQTIMING_H
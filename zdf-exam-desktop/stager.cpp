@@ -0,0 +1,616 @@
+#include "stager.h"
+#include "config.h"
+#include "logger.h"
+#include "packbuilder.h"
+#include "packformat.h"
+#include "peershare.h"
+
+#include <QCoreApplication>
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#include <QEventLoop>
+#include <QTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDirIterator>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QCryptographicHash>
+#include <QStandardPaths>
+#include <QElapsedTimer>
+#include <QSysInfo>
+#include <QDateTime>
+#include <QSet>
+#include <QUrl>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <random>
+#include <vector>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+// --------------------------- 预取清单 ---------------------------
+// {"baseUrl": "http://stu.sdzdf.com/",                 可省略，默认为清单所在目录
+//  "files": ["static/js/app.js",                        只给路径
+//            {"path": "static/img/bg.png", "size": 1024, "sha256": "…"}]}
+struct StageItem {
+    QString path;               // 相对基准地址，同时是预取目录下的相对路径
+    QUrl url;
+    qint64 size = -1;           // -1 表示清单未给出
+    QByteArray sha256;          // 小写十六进制，空表示清单未给出
+    int attempts = 0;
+    int peerAttempts = 0;       // 已尝试过的同伴数，不计入 attempts
+    int peerStart = 0;          // 从同伴列表的哪一位开始尝试，使各文件分散到不同同伴
+
+    bool verifiable() const { return size >= 0 || !sha256.isEmpty(); }
+};
+
+static const char PART_SUFFIX[] = ".part";
+static const char VALIDATOR_SUFFIX[] = ".if-range.part";   // .part 对应的 ETag 或 Last-Modified，同样不打包
+static const char PEER_PART_SUFFIX[] = ".peer.part";        // 从同伴下载的临时文件，与源站的续传进度分开
+static const int TICK_MS = 100;                 // 限速时按该间隔分配下载额度
+static const qint64 READ_BUFFER = 64 * 1024;    // 限速时每个连接的接收缓冲，缓冲满后 TCP 自然减速
+static const int RETRY_BASE_MS = 2000;          // 第 n 次重试前等待 RETRY_BASE_MS * 2^(n-1)，另加随机抖动
+static const int PROGRESS_MS = 1000;
+static const int MAX_PEER_ATTEMPTS = 3;         // 每个文件最多尝试的同伴数，之后改从源站下载
+static const int PEER_IDLE_MS = 5000;           // 同伴在该时间内没有数据到达时放弃
+
+// 清单给出的大小和摘要均一致时视为完整
+static bool verifyFile(const QString &path, const StageItem &item) {
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return false;
+    if (item.size >= 0 && f.size() != item.size) return false;
+    if (item.sha256.isEmpty()) return true;
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    return hash.addData(&f) && hash.result().toHex() == item.sha256;
+}
+
+// 合法的相对路径：不以 / 开头、不含 .. 段，避免清单把文件写到预取目录之外
+static bool safeRelativePath(const QString &path) {
+    if (path.isEmpty() || path.startsWith('/') || path.contains('\\') || path.contains(':')) return false;
+    for (const QString &part : path.split('/'))
+        if (part.isEmpty() || part == "." || part == "..") return false;
+    return !path.endsWith(PART_SUFFIX);
+}
+
+// --------------------------- Stager ---------------------------
+class Stager {
+public:
+    Stager(const AppConfig &config, const QString &dir)
+        : m_config(config), m_conf(config.staging), m_dir(dir), m_limited(m_conf.bandwidthKBps > 0) {
+        // 以主机名、进程号和时间为种子，同一时刻启动的各座位得到不同的延迟
+        std::seed_seq seed{uint(qHash(QSysInfo::machineHostName())), uint(QCoreApplication::applicationPid()),
+                           uint(QDateTime::currentMSecsSinceEpoch())};
+        m_random.seed(seed);
+    }
+
+    int run(const QString &manifestLocation, bool now, const QString &packPath) {
+        if (!QDir().mkpath(m_dir)) return fail(QString("无法创建预取目录：%1").arg(m_dir));
+
+        if (!now && m_conf.startWindowSec > 0) {
+            const int delayMs = std::uniform_int_distribution<int>(0, m_conf.startWindowSec * 1000 - 1)(m_random);
+            printf("本机在 %d 秒后开始下载（时间窗 %d 秒，--now 可立即开始）\n", delayMs / 1000, m_conf.startWindowSec);
+            fflush(stdout);
+            wait(delayMs);
+        }
+        m_clock.start();
+
+        QString error;
+        if (!loadManifest(manifestLocation, error)) return fail(error);
+        ZDF_LOG_EVENT(CatStage, L_INFO, "开始预取：清单 %1，%2 个文件，目录 %3", manifestLocation, int(m_queue.size()), m_dir);
+        ZDF_LOG_EVENT(CatStage, L_INFO, "预取参数：同时下载 %1 个，带宽上限 %2 KB/s，重试 %3 次",
+                      m_conf.concurrency, m_conf.bandwidthKBps, m_conf.retries);
+        startSharing();
+
+        QTimer tick, progress;
+        if (m_limited) {
+            QObject::connect(&tick, &QTimer::timeout, [this]() { pumpLimited(); });
+            tick.start(TICK_MS);
+        }
+        QObject::connect(&progress, &QTimer::timeout, [this]() { printProgress(); });
+        progress.start(PROGRESS_MS);
+
+        startNext();
+        if (!finished()) m_loop.exec();
+        tick.stop();
+        progress.stop();
+        printProgress();
+        printf("\n");
+
+        removeUnlisted();
+        const double seconds = double(m_clock.elapsed()) / 1000.0;
+        ZDF_LOG_EVENT(CatStage, L_INFO, "预取结束：下载 %1 个，已是最新 %2 个，失败 %3 个",
+                      m_downloaded, m_upToDate, int(m_failed.size()));
+        ZDF_LOG_EVENT(CatStage, L_INFO, "预取流量：%1 KB，耗时 %2 秒，平均 %3 KB/s",
+                      m_receivedBytes / 1024, seconds, seconds > 0 ? double(m_receivedBytes) / 1024.0 / seconds : 0.0);
+        if (m_share) {
+            ZDF_LOG_EVENT(CatStage, L_INFO, "同伴共享：从同伴获取 %1 个文件，节省源站流量 %2 KB，同伴失败 %3 次",
+                          m_peerFiles, m_peerBytes / 1024, m_peerFailures);
+            printf("从同伴获取 %d 个文件，节省源站流量 %.1f MB\n", m_peerFiles, double(m_peerBytes) / (1024 * 1024));
+        }
+        if (!m_failed.isEmpty()) {
+            for (const QString &f : m_failed) ZDF_LOG_EVENT(CatStage, L_WARNING, "下载失败：%1", f);
+            return fail(QString("%1 个文件下载失败，资源包未更新").arg(m_failed.size()));
+        }
+
+        zdfpack::BuildResult result;
+        if (!zdfpack::buildPack(m_dir, m_baseUrl.toString(), packPath, result, PART_SUFFIX))
+            return fail(QString("生成资源包失败：%1").arg(result.error));
+        ZDF_LOG_EVENT(CatStage, L_INFO, "资源包已生成：%1，%2 个文件，%3 MB", packPath, result.files,
+                      double(result.bytes) / (1024 * 1024));
+        printf("资源包已生成：%s（%d 个文件，%.1f MB）\n", qPrintable(packPath), result.files,
+               double(result.bytes) / (1024 * 1024));
+        seed();
+        return 0;
+    }
+
+private:
+    struct Active {
+        StageItem item;
+        QNetworkReply *reply = nullptr;
+        QFile file;                 // .part 文件，收到第一段数据时按应答状态打开
+        QString validatorPath;      // 续传校验值文件，从同伴下载时为空
+        bool opened = false;
+        bool rangeMismatch = false;
+        bool fromPeer = false;
+        bool throttled = false;     // 受带宽上限约束；同伴之间的传输不经过学校出口，不限速
+        qint64 received = 0;
+    };
+
+    int fail(const QString &message) {
+        ZDF_LOG_EVENT(CatStage, L_ERROR, "%1", message);
+        fprintf(stderr, "%s\n", qPrintable(message));
+        if (m_share) m_share->logStats(CatStage, "预取期间");
+        return 1;
+    }
+
+    void wait(int ms) {
+        QEventLoop loop;
+        QTimer::singleShot(ms, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+
+    QString finalPath(const QString &path) const { return m_dir + "/" + path; }
+    QString finalPath(const StageItem &item) const { return finalPath(item.path); }
+
+    // ---------- 清单 ----------
+    bool loadManifest(const QString &location, QString &error) {
+        const QUrl url = QUrl::fromUserInput(location, QDir::currentPath(), QUrl::AssumeLocalFile);
+        QByteArray data;
+        if (url.isLocalFile()) {
+            QFile f(url.toLocalFile());
+            if (!f.open(QIODevice::ReadOnly)) { error = QString("无法读取清单：%1").arg(location); return false; }
+            data = f.readAll();
+        } else {
+            // 清单很小，失败时按同样的退避重试
+            for (int attempt = 0; ; ++attempt) {
+                QNetworkRequest request(url);
+                request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
+                QNetworkReply *reply = m_nam.get(request);
+                QEventLoop loop;
+                QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+                loop.exec();
+                reply->deleteLater();
+                if (reply->error() == QNetworkReply::NoError) { data = reply->readAll(); break; }
+                if (attempt >= m_conf.retries) {
+                    error = QString("无法下载清单 %1：%2").arg(location, reply->errorString());
+                    return false;
+                }
+                wait(retryDelayMs(attempt + 1));
+            }
+        }
+
+        QJsonParseError e;
+        const QJsonObject manifest = QJsonDocument::fromJson(data, &e).object();
+        if (manifest.isEmpty()) { error = QString("清单格式错误：%1").arg(e.errorString()); return false; }
+        const QString base = manifest.value("baseUrl").toString();
+        m_baseUrl = !base.isEmpty() ? QUrl(base) : (url.isLocalFile() ? QUrl() : url.resolved(QUrl(".")));
+        if (!m_baseUrl.isValid() || m_baseUrl.host().isEmpty() || !m_baseUrl.path().endsWith('/')) {
+            error = QString("清单缺少有效的 baseUrl（以 / 结尾的完整地址）");
+            return false;
+        }
+
+        for (const QJsonValue &v : manifest.value("files").toArray()) {
+            StageItem item;
+            const QJsonObject o = v.toObject();
+            item.path = v.isString() ? v.toString() : o.value("path").toString();
+            if (!safeRelativePath(item.path) || m_listed.contains(item.path)) {
+                ZDF_LOG_EVENT(CatStage, L_WARNING, "清单中的路径无效或重复，已跳过：%1", item.path);
+                continue;
+            }
+            item.url = m_baseUrl.resolved(QUrl(item.path));
+            item.size = qint64(o.value("size").toDouble(-1));
+            item.sha256 = o.value("sha256").toString().toLower().toLatin1();
+            m_listed.insert(item.path);
+            ++m_total;
+
+            // 已下载且校验通过的文件跳过；无法校验的交给条件请求判断
+            if (item.verifiable() && verifyFile(finalPath(item), item)) {
+                ++m_upToDate;
+                m_completed.insert(item.path);
+            } else {
+                m_queue.push_back(item);
+            }
+        }
+        return true;
+    }
+
+    // ---------- 同伴共享 ----------
+    // 已校验的文件提供给同伴；启动后先收一轮通告，再开始下载
+    void startSharing() {
+        if (!m_config.peerShare.enabled) return;
+        m_share.reset(new PeerShare(m_config, m_baseUrl, [this](const QString &path) -> QIODevice* {
+            if (!m_completed.contains(path)) return nullptr;
+            QFile *file = new QFile(finalPath(path));
+            if (!file->open(QIODevice::ReadOnly)) {
+                delete file;
+                return nullptr;
+            }
+            return file;
+        }));
+        m_share->setFileCount(m_completed.size());
+        if (!m_share->start()) {
+            m_share.reset();
+            return;
+        }
+        if (!m_queue.empty()) wait(PeerShare::ANNOUNCE_MS + 500);
+        ZDF_LOG_EVENT(CatStage, L_INFO, "同伴共享：可用同伴 %1 个，本机已有 %2 个文件",
+                      m_share->peers().size(), m_completed.size());
+    }
+
+    // 预取成功后按 peerShare.seedSec 继续提供文件，供后开始的座位取用
+    void seed() {
+        if (!m_share) return;
+        if (m_config.peerShare.seedSec > 0) {
+            printf("继续向同伴提供文件 %d 秒\n", m_config.peerShare.seedSec);
+            fflush(stdout);
+            wait(m_config.peerShare.seedSec * 1000);
+        }
+        m_share->logStats(CatStage, "预取期间");
+    }
+
+    // ---------- 下载 ----------
+    bool finished() const { return m_queue.empty() && m_active.empty() && m_pendingRetries == 0; }
+
+    void startNext() {
+        while (int(m_active.size()) < m_conf.concurrency && !m_queue.empty()) {
+            start(m_queue.front());
+            m_queue.pop_front();
+        }
+        if (finished()) m_loop.quit();
+    }
+
+    void start(StageItem item) {
+        std::unique_ptr<Active> a(new Active);
+        const QString target = finalPath(item);
+        QDir().mkpath(QFileInfo(target).absolutePath());
+
+        // 清单给出 sha256 的文件先向同伴请求，收到后照常校验，不一致时改从下一个同伴或源站下载。
+        // 同伴的内容写入单独的临时文件：源站中断留下的 .part 和续传校验值保持不变，同伴都失败后仍可续传
+        const QList<PeerEndpoint> peers = m_share && !item.sha256.isEmpty() ? m_share->peers() : QList<PeerEndpoint>();
+        if (item.peerAttempts == 0 && !peers.isEmpty())
+            item.peerStart = std::uniform_int_distribution<int>(0, peers.size() - 1)(m_random);
+        a->fromPeer = item.peerAttempts < qMin(peers.size(), MAX_PEER_ATTEMPTS);
+        if (a->fromPeer) {
+            a->file.setFileName(target + PEER_PART_SUFFIX);
+        } else {
+            a->file.setFileName(target + PART_SUFFIX);
+            a->validatorPath = target + VALIDATOR_SUFFIX;
+        }
+        a->throttled = m_limited && !a->fromPeer;
+        a->item = item;
+
+        QNetworkRequest request(item.url);
+        if (a->fromPeer) {
+            request.setUrl(PeerShare::assetUrl(peers.at((item.peerStart + item.peerAttempts) % peers.size()), item.path));
+            request.setRawHeader(PeerShare::BASE_HEADER, m_baseUrl.toString().toUtf8());
+        } else {
+            // 有未完成的 .part 时续传：带 If-Range，服务器文件已变化时回 200 整个文件而不是续接到旧内容后；
+            // 没有保存校验值时只有清单给出 sha256 才续传（拼接出错能被校验发现），否则从头下载。
+            // 没有 .part、已有文件且清单无法校验时发条件请求，未变化则服务器回 304
+            request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
+            qint64 have = QFileInfo(a->file.fileName()).size();
+            QByteArray validator;
+            if (have > 0) {
+                QFile v(a->validatorPath);
+                if (v.open(QIODevice::ReadOnly)) validator = v.readAll().trimmed();
+                if (validator.isEmpty() && item.sha256.isEmpty()) {
+                    discardPart(a.get());
+                    have = 0;
+                }
+            }
+            if (have > 0) {
+                request.setRawHeader("Range", "bytes=" + QByteArray::number(have) + "-");
+                if (!validator.isEmpty()) request.setRawHeader("If-Range", validator);
+            } else if (!item.verifiable() && QFileInfo::exists(target)) {
+                request.setHeader(QNetworkRequest::IfModifiedSinceHeader, QFileInfo(target).lastModified());
+            }
+        }
+
+        QNetworkReply *reply = m_nam.get(request);
+        a->reply = reply;
+        if (a->throttled) reply->setReadBufferSize(READ_BUFFER);
+        else QObject::connect(reply, &QNetworkReply::readyRead, [this, reply]() {
+            if (Active *x = find(reply)) write(x, reply->readAll());
+        });
+        QObject::connect(reply, &QNetworkReply::finished, [this, reply]() {
+            Active *x = find(reply);
+            if (!x || (x->throttled && reply->bytesAvailable() > 0)) return;   // 限速时由 pumpLimited 读完后收尾
+            if (!x->throttled) write(x, reply->readAll());
+            complete(x);
+        });
+        if (a->fromPeer) {
+            QTimer *idle = new QTimer(reply);
+            idle->setSingleShot(true);
+            QObject::connect(idle, &QTimer::timeout, reply, &QNetworkReply::abort);
+            QObject::connect(reply, &QNetworkReply::readyRead, idle, [idle]() { idle->start(PEER_IDLE_MS); });
+            idle->start(PEER_IDLE_MS);
+        }
+        m_active.push_back(std::move(a));
+    }
+
+    Active *find(QNetworkReply *reply) const {
+        for (const auto &a : m_active) if (a->reply == reply) return a.get();
+        return nullptr;
+    }
+
+    // 限速：每个周期的额度在活动连接之间平分，用不完的额度不累积
+    void pumpLimited() {
+        const qint64 throttled = std::count_if(m_active.begin(), m_active.end(),
+                                               [](const std::unique_ptr<Active> &a) { return a->throttled; });
+        if (throttled == 0) return;
+        const qint64 budget = qint64(m_conf.bandwidthKBps) * 1024 * TICK_MS / 1000;
+        const qint64 share = qMax<qint64>(1, budget / throttled);
+        std::vector<Active*> done;
+        for (const auto &a : m_active) {
+            if (!a->throttled) continue;
+            const qint64 n = qMin(share, a->reply->bytesAvailable());
+            if (n > 0) write(a.get(), a->reply->read(n));
+            if (a->reply->isFinished() && a->reply->bytesAvailable() == 0) done.push_back(a.get());
+        }
+        for (Active *a : done) complete(a);
+    }
+
+    static int status(QNetworkReply *reply) {
+        return reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    }
+
+    void write(Active *a, const QByteArray &data) {
+        if (data.isEmpty() || !openPart(a)) return;
+        a->file.write(data);
+        a->received += data.size();
+        if (a->fromPeer) m_peerReceived += data.size();
+        else m_receivedBytes += data.size();
+    }
+
+    void discardPart(Active *a) {
+        a->file.close();
+        QFile::remove(a->file.fileName());
+        QFile::remove(a->validatorPath);
+    }
+
+    // 从头写入时记下服务器的强 ETag（弱 ETag 不能用于 If-Range）或 Last-Modified，供中断后续传
+    void saveValidator(Active *a) {
+        QByteArray validator = a->reply->rawHeader("ETag");
+        if (validator.isEmpty() || validator.startsWith("W/")) validator = a->reply->rawHeader("Last-Modified");
+        if (validator.isEmpty()) {
+            QFile::remove(a->validatorPath);
+            return;
+        }
+        QFile v(a->validatorPath);
+        if (v.open(QIODevice::WriteOnly | QIODevice::Truncate)) v.write(validator);
+    }
+
+    // 206 时检查续传起点与本地已有长度一致后追加，200 时从头写。其他状态（错误页等）的内容不写入，
+    // 已有的 .part 和续传校验值保持不变，否则错误页会被当作下载内容，下次以它的长度续传
+    bool openPart(Active *a) {
+        if (a->opened) return a->file.isOpen();
+        a->opened = true;
+        const int code = status(a->reply);
+        if (code != 200 && code != 206) return false;
+        if (code == 206) {
+            const QByteArray range = a->reply->rawHeader("Content-Range");   // bytes 起点-终点/总长
+            const qint64 start = range.mid(6, range.indexOf('-') - 6).trimmed().toLongLong();
+            if (!range.startsWith("bytes ") || start != QFileInfo(a->file.fileName()).size()) {
+                // 不能在读数据的过程中同步中止（finished 会随之触发并释放 a），回到事件循环再中止
+                a->rangeMismatch = true;
+                QNetworkReply *reply = a->reply;
+                QTimer::singleShot(0, reply, [reply]() { reply->abort(); });
+                return false;
+            }
+            return a->file.open(QIODevice::WriteOnly | QIODevice::Append);
+        }
+        if (!a->fromPeer) saveValidator(a);
+        return a->file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    }
+
+    void complete(Active *a) {
+        QNetworkReply *reply = a->reply;
+        StageItem item = a->item;
+        const int code = status(reply);
+        QString error;
+        if (a->rangeMismatch || code == 416) {
+            // 本地 .part 与服务器文件对不上，删除后从头下载
+            discardPart(a);
+            error = QString("续传起点与本地文件不一致");
+        } else if (reply->error() != QNetworkReply::NoError) {
+            error = reply->errorString();
+        } else if (code == 304) {
+            ++m_upToDate;
+        } else if (code != 200 && code != 206) {
+            error = QString("服务器返回 %1").arg(code);
+        } else if (a->opened && !a->file.isOpen()) {
+            error = QString("无法写入 %1").arg(a->file.fileName());
+        } else {
+            if (!a->opened) openPart(a);        // 空文件没有收到过数据
+            a->file.close();
+            const QString target = finalPath(item);
+            if (!verifyFile(a->file.fileName(), item)) {
+                discardPart(a);
+                error = QString("大小或 sha256 与清单不一致");
+            } else if ((QFile::exists(target) && !QFile::remove(target)) || !QFile::rename(a->file.fileName(), target)) {
+                error = QString("无法写入 %1").arg(target);
+            } else {
+                // 源站的续传进度已无用（从同伴取得时同样删除）
+                QFile::remove(target + PART_SUFFIX);
+                QFile::remove(target + VALIDATOR_SUFFIX);
+                ++m_downloaded;
+                m_completed.insert(item.path);
+                if (m_share) m_share->setFileCount(m_completed.size());
+                if (a->fromPeer) {
+                    ++m_peerFiles;
+                    m_peerBytes += a->received;
+                }
+            }
+        }
+
+        const bool peerFailed = a->fromPeer && !error.isEmpty();
+        if (peerFailed) {
+            // 同伴给出的部分内容不可信，不留作续传；换下一个同伴（或源站）立即重试，不计入重试次数
+            a->file.close();
+            QFile::remove(a->file.fileName());
+            ++m_peerFailures;
+            ++item.peerAttempts;
+            ZDF_LOG_EVENT(CatStage, L_DEBUG, "从同伴 %1 获取 %2 失败（%3）", reply->url().authority(), item.path, error);
+        }
+        reply->deleteLater();
+        for (auto it = m_active.begin(); it != m_active.end(); ++it)
+            if (it->get() == a) { m_active.erase(it); break; }
+        if (peerFailed) m_queue.push_front(item);
+        else if (!error.isEmpty()) retryOrFail(item, error);
+        startNext();
+    }
+
+    int retryDelayMs(int attempt) {
+        const int base = RETRY_BASE_MS << qMin(attempt - 1, 5);
+        return base + std::uniform_int_distribution<int>(0, base / 2)(m_random);
+    }
+
+    void retryOrFail(StageItem item, const QString &error) {
+        if (++item.attempts > m_conf.retries) {
+            m_failed << QString("%1（%2）").arg(item.path, error);
+            return;
+        }
+        ZDF_LOG_EVENT(CatStage, L_WARNING, "下载 %1 失败（%2），第 %3 次重试", item.path, error, item.attempts);
+        ++m_pendingRetries;
+        QTimer::singleShot(retryDelayMs(item.attempts), [this, item]() {
+            --m_pendingRetries;
+            m_queue.push_back(item);
+            startNext();
+        });
+    }
+
+    void printProgress() {
+        const double seconds = qMax(0.001, double(m_clock.elapsed()) / 1000.0);
+        printf("\r已完成 %d/%d，下载中 %d，失败 %d，已接收 %.1f MB，平均 %.0f KB/s，来自同伴 %.1f MB   ",
+               m_downloaded + m_upToDate, m_total, int(m_active.size()), m_failed.size(),
+               double(m_receivedBytes) / (1024 * 1024), double(m_receivedBytes) / 1024.0 / seconds,
+               double(m_peerReceived) / (1024 * 1024));
+        fflush(stdout);
+    }
+
+    // 清单之外的文件（含以前的版本和残留的 .part）不打进资源包
+    void removeUnlisted() {
+        QDirIterator it(m_dir, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+        QDir root(m_dir);
+        while (it.hasNext()) {
+            const QString file = it.next();
+            const QString rel = root.relativeFilePath(file);
+            const bool pending = rel.endsWith(PART_SUFFIX) && m_failed.isEmpty();
+            if (!m_listed.contains(rel) && (pending || !rel.endsWith(PART_SUFFIX))) QFile::remove(file);
+        }
+    }
+
+    const AppConfig &m_config;          // 快照在进程生命周期内有效
+    const AppConfig::Staging m_conf;
+    const QString m_dir;
+    const bool m_limited;
+    std::mt19937 m_random;
+    QNetworkAccessManager m_nam;
+    QEventLoop m_loop;
+    QElapsedTimer m_clock;
+    QUrl m_baseUrl;
+    QSet<QString> m_listed;
+    std::deque<StageItem> m_queue;
+    std::vector<std::unique_ptr<Active>> m_active;
+    int m_pendingRetries = 0;
+    int m_total = 0, m_downloaded = 0, m_upToDate = 0;
+    qint64 m_receivedBytes = 0;         // 来自源站
+    QStringList m_failed;
+    QSet<QString> m_completed;          // 已校验、可提供给同伴的文件
+    std::unique_ptr<PeerShare> m_share;
+    int m_peerFiles = 0, m_peerFailures = 0;
+    qint64 m_peerBytes = 0;             // 从同伴获取并校验通过的字节，即节省的源站流量
+    qint64 m_peerReceived = 0;
+};
+
+// --------------------------- 入口 ---------------------------
+bool hasStageFlag(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i)
+        if (strcmp(argv[i], "--stage") == 0) return true;
+    return false;
+}
+
+static QString resolvePath(const QString &path) {
+    return QDir::isAbsolutePath(path) ? path : QCoreApplication::applicationDirPath() + "/" + path;
+}
+
+int runStaging(int argc, char *argv[]) {
+#ifdef Q_OS_WIN
+    // 程序为窗口子系统，从命令行运行时把输出接到父进程的控制台
+    if (AttachConsole(ATTACH_PARENT_PROCESS)) {
+        freopen("CONOUT$", "w", stdout);
+        freopen("CONOUT$", "w", stderr);
+        SetConsoleOutputCP(CP_UTF8);
+    }
+#endif
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    const int flag = args.indexOf("--stage");
+    const QString argument = args.value(flag + 1);
+    const bool now = args.contains("--now");
+
+    ConfigManager &cfg = ConfigManager::instance();
+    if (!cfg.loadConfig()) {
+        fprintf(stderr, "未找到有效配置文件\n");
+        Logger::instance().shutdown();
+        return 2;
+    }
+    const AppConfig &conf = cfg.snapshot();
+    Logger::instance().setLogLevel(conf.log.level);
+    Logger::instance().setRotationPolicy(qint64(conf.log.maxFileSizeMB) * 1024 * 1024, conf.log.maxBackups);
+    Logger::instance().setBinaryFormat(conf.log.binaryFormat);
+
+    const QString manifest = (!argument.isEmpty() && !argument.startsWith("--")) ? argument : conf.staging.manifestUrl;
+    if (manifest.isEmpty()) {
+        fprintf(stderr, "用法: zdf-exam-desktop --stage [清单地址或文件] [--now]\n"
+                        "未指定清单时使用配置文件中的 staging.manifestUrl\n");
+        Logger::instance().shutdown();
+        return 2;
+    }
+    const QString dir = conf.staging.directory.isEmpty()
+        ? QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/staging"
+        : resolvePath(conf.staging.directory);
+    QString packPath;
+    if (!conf.assetPack.path.isEmpty()) {
+        packPath = resolvePath(conf.assetPack.path);
+    } else {
+        packPath = QFileInfo(dir).absolutePath() + "/exam" + zdfpack::PACK_SUFFIX;
+        printf("配置文件未设置 assetPack.path，资源包将写入 %s，须将 assetPack.path 设为该路径才会使用\n",
+               qPrintable(packPath));
+    }
+
+    Stager stager(conf, QDir::cleanPath(dir));
+    const int code = stager.run(manifest, now, packPath);
+    Logger::instance().shutdown();
+    return code;
+}
@@ -0,0 +1,16 @@
+#ifndef ZDF_STAGER_H
+#define ZDF_STAGER_H
+
+// --------------------------- 考前预取 ---------------------------
+// zdf-exam-desktop --stage [清单地址或文件] [--now]
+// 不创建界面：按清单把考试资源下载到本机的预取目录，再生成 assetPack.path 指向的资源包后退出，
+// 考试时页面直接从资源包读取，避免开考瞬间几十台终端同时挤占学校出口带宽。
+// - 每台终端在 staging.startWindowSec 内随机延迟开始（--now 跳过），错开各座位的请求
+// - 同时下载数和本机总带宽均有上限；中断后保留 .part 文件，下次以 Range 请求续传
+// - 清单给出 size/sha256 时校验；已下载且未变化的文件不再重复下载
+// - 启用 peerShare 时有 sha256 的文件先向同一网段的其他终端请求，同时把已校验的文件提供给它们
+// 成功返回 0；有文件下载失败时返回 1，并保留原有资源包不变
+bool hasStageFlag(int argc, char *argv[]);
+int runStaging(int argc, char *argv[]);
+
+#endif // ZDF_STAGER_H
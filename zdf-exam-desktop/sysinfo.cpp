@@ -0,0 +1,530 @@
+#include "sysinfo.h"
+
+#include "logger.h"
+
+#include <QSysInfo>
+#include <QStringList>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QThread>
+#include <QElapsedTimer>
+
+#include <memory>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#ifdef Q_OS_LINUX
+#include <QMap>
+
+#include <cmath>
+
+// --------------------------- Linux 探测辅助 ---------------------------
+static const quint64 LOW_MEMORY_THRESHOLD_MB = 4096;
+
+static QByteArray readProcFile(const QString &path) {
+    // /proc 与 /sys 下的文件大小报告为 0，readAll 会一直读到 EOF
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return QByteArray();
+    return f.readAll().trimmed();
+}
+
+// /proc/meminfo 中 "MemTotal:  8048576 kB" 形式的字段，返回 MB
+static quint64 meminfoMB(const QByteArray &meminfo, const char *key) {
+    for (const QByteArray &line : meminfo.split('\n')) {
+        if (!line.startsWith(key)) continue;
+        const QList<QByteArray> parts = line.simplified().split(' ');
+        return parts.size() >= 2 ? parts.at(1).toULongLong() / 1024 : 0;
+    }
+    return 0;
+}
+
+// 本进程在指定 cgroup v1 控制器下的路径；v2 统一层级的控制器名为空
+static QString cgroupPath(const QByteArray &selfCgroup, const QByteArray &controller) {
+    for (const QByteArray &line : selfCgroup.split('\n')) {
+        const QList<QByteArray> parts = line.split(':');
+        if (parts.size() < 3) continue;
+        if (controller.isEmpty() ? parts.at(1).isEmpty() : parts.at(1).split(',').contains(controller))
+            return QString::fromUtf8(parts.at(2));
+    }
+    return QString();
+}
+
+// 先查本进程所在 cgroup，再查根层级（容器内通常只能看到根）
+static QByteArray readCgroupFile(const QString &base, const QString &path, const char *file) {
+    QByteArray value;
+    if (!path.isEmpty() && path != "/") value = readProcFile(base + path + "/" + file);
+    if (value.isEmpty()) value = readProcFile(base + "/" + file);
+    return value;
+}
+
+// cgroup 内存上限（MB），无限制返回 0
+static quint64 cgroupMemoryLimitMB(const QByteArray &selfCgroup) {
+    QByteArray limit;
+    const QString v2 = cgroupPath(selfCgroup, QByteArray());
+    if (QFile::exists("/sys/fs/cgroup/cgroup.controllers")) {
+        limit = readCgroupFile("/sys/fs/cgroup", v2, "memory.max");
+    } else {
+        limit = readCgroupFile("/sys/fs/cgroup/memory", cgroupPath(selfCgroup, "memory"), "memory.limit_in_bytes");
+    }
+    bool ok = false;
+    const quint64 bytes = limit.toULongLong(&ok);   // "max" 或 v1 的超大值都视为无限制
+    if (!ok || bytes >= (quint64(1) << 60)) return 0;
+    return bytes / (1024 * 1024);
+}
+
+// cgroup 当前内存用量（MB），读取失败返回 0
+static quint64 cgroupMemoryUsageMB(const QByteArray &selfCgroup) {
+    QByteArray usage;
+    if (QFile::exists("/sys/fs/cgroup/cgroup.controllers")) {
+        usage = readCgroupFile("/sys/fs/cgroup", cgroupPath(selfCgroup, QByteArray()), "memory.current");
+    } else {
+        usage = readCgroupFile("/sys/fs/cgroup/memory", cgroupPath(selfCgroup, "memory"), "memory.usage_in_bytes");
+    }
+    return usage.toULongLong() / (1024 * 1024);
+}
+
+// cgroup CPU 配额折算的核心数（向上取整），无限制返回 0
+static int cgroupCpuLimit(const QByteArray &selfCgroup) {
+    qint64 quota = -1, period = 0;
+    if (QFile::exists("/sys/fs/cgroup/cgroup.controllers")) {
+        // cpu.max: "<quota> <period>" 或 "max <period>"
+        const QList<QByteArray> parts = readCgroupFile("/sys/fs/cgroup", cgroupPath(selfCgroup, QByteArray()), "cpu.max").split(' ');
+        if (parts.size() == 2 && parts.at(0) != "max") { quota = parts.at(0).toLongLong(); period = parts.at(1).toLongLong(); }
+    } else {
+        const QString path = cgroupPath(selfCgroup, "cpu");
+        quota = readCgroupFile("/sys/fs/cgroup/cpu", path, "cpu.cfs_quota_us").toLongLong();
+        period = readCgroupFile("/sys/fs/cgroup/cpu", path, "cpu.cfs_period_us").toLongLong();
+    }
+    if (quota <= 0 || period <= 0) return 0;
+    return qMax(1, int(std::ceil(double(quota) / double(period))));
+}
+
+// ARM 核心型号（/proc/cpuinfo 的 CPU implementer + CPU part），仅用于日志中的 CPU 描述
+struct ArmCore { int implementer; int part; const char *name; };
+static const ArmCore ARM_CORES[] = {
+    {0x41, 0xd03, "Cortex-A53"},
+    {0x41, 0xd04, "Cortex-A35"},
+    {0x41, 0xd05, "Cortex-A55"},
+    {0x41, 0xd07, "Cortex-A57"},
+    {0x41, 0xd08, "Cortex-A72"},
+    {0x41, 0xd09, "Cortex-A73"},
+    {0x41, 0xd0a, "Cortex-A75"},
+    {0x41, 0xd0b, "Cortex-A76"},
+    {0x41, 0xd0c, "Neoverse-N1"},
+    {0x48, 0xd01, "TaiShan-v110"},      // 鲲鹏 920
+    {0x70, 0x660, "FTC660"},            // 飞腾 FT-1500A
+    {0x70, 0x661, "FTC661"},
+    {0x70, 0x662, "FTC662"},            // 飞腾 FT-2000+
+    {0x70, 0x663, "FTC663"},            // 飞腾 FT-2000/4、D2000
+    {0x70, 0x862, "FTC862"},            // 飞腾 S2500
+};
+
+static const ArmCore *findArmCore(int implementer, int part) {
+    for (const ArmCore &core : ARM_CORES)
+        if (core.implementer == implementer && core.part == part) return &core;
+    return nullptr;
+}
+
+// DMI / 设备树 / hypervisor 标志判断虚拟化平台，返回平台名，物理机返回空
+static QString detectVirtualization(bool hypervisorFlag) {
+    static const char *const VENDORS[] = {"QEMU", "KVM", "VMware", "VirtualBox", "Xen", "Bochs",
+                                          "Parallels", "OpenStack", "Virtual Machine", "HVM domU"};
+    const QString dmi = QString::fromUtf8(readProcFile("/sys/class/dmi/id/sys_vendor") + " " +
+                                          readProcFile("/sys/class/dmi/id/product_name"));
+    for (const char *vendor : VENDORS)
+        if (dmi.contains(QLatin1String(vendor), Qt::CaseInsensitive)) return QString::fromLatin1(vendor);
+
+    const QByteArray hypervisor = readProcFile("/sys/hypervisor/type");
+    if (!hypervisor.isEmpty()) return QString::fromUtf8(hypervisor);
+    // ARM 虚拟机：设备树带 hypervisor 节点或为 QEMU virt 机型
+    if (QFile::exists("/proc/device-tree/hypervisor")) return "hypervisor";
+    if (readProcFile("/proc/device-tree/compatible").contains("linux,dummy-virt")) return "QEMU";
+    if (hypervisorFlag) return "hypervisor";
+    return QString();
+}
+#endif
+
+// --------------------------- 性能评分 ---------------------------
+// 用实测的 CPU 吞吐、内存带宽和磁盘落盘延迟代替按 CPU 型号名匹配：赛扬、奔腾、兆芯、飞腾、
+// 鲲鹏等型号名无法可靠判断性能。各项以参考机器（近年主流台式机）为 1.0 归一化后加权求和。
+// 启动时只测 CPU 和内存（有时限）；单次 fsync 在机械硬盘或繁忙的虚拟机上可能长达数百毫秒，
+// 落盘延迟改在后台线程测量并写入缓存，下次启动计入评分，未测得前该项按中性值计算。
+static const int CPU_BUDGET_MS = 25;
+static const int MEMORY_BUDGET_MS = 25;
+static const int STORAGE_BUDGET_MS = 40;
+static const int MEMORY_BUFFER_BYTES = 8 * 1024 * 1024;    // 超出多数 CPU 的二级缓存
+static const int STORAGE_WRITE_BYTES = 4096;
+static const int STORAGE_MAX_WRITES = 3;
+
+static const double REF_CPU_MOPS = 350.0;
+static const double REF_CORES = 4.0;
+static const double REF_MEMORY_MBPS = 10000.0;
+static const double REF_STORAGE_WRITE_MS = 2.0;
+
+static const int LOW_PROFILE_SCORE = 80;    // 低于该分数按老旧 CPU 处理，启用保守模式
+static const int HIGH_PROFILE_SCORE = 130;
+
+// 单线程整数吞吐：xorshift 依赖链，编译器无法向量化或消除
+static double measureCpuMops() {
+    QElapsedTimer timer;
+    timer.start();
+    quint64 x = 88172645463325252ULL, acc = 0, iterations = 0;
+    const int CHUNK = 16384;
+    do {
+        for (int i = 0; i < CHUNK; ++i) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            acc += x * 0x9E3779B97F4A7C15ULL;
+        }
+        iterations += CHUNK;
+    } while (timer.elapsed() < CPU_BUDGET_MS);
+    volatile quint64 sink = acc; (void)sink;
+    return double(iterations) / (double(timer.nsecsElapsed()) / 1000.0);
+}
+
+static double measureMemoryMBps() {
+    std::unique_ptr<char[]> src(new char[MEMORY_BUFFER_BYTES]), dst(new char[MEMORY_BUFFER_BYTES]);
+    memset(src.get(), 1, MEMORY_BUFFER_BYTES);
+    memset(dst.get(), 0, MEMORY_BUFFER_BYTES);     // 预先触碰页面，不把缺页计入带宽
+    QElapsedTimer timer;
+    timer.start();
+    qint64 bytes = 0;
+    do {
+        memcpy(dst.get(), src.get(), MEMORY_BUFFER_BYTES);
+        src[bytes & 4095] ^= dst[MEMORY_BUFFER_BYTES - 1];
+        bytes += MEMORY_BUFFER_BYTES;
+    } while (timer.elapsed() < MEMORY_BUDGET_MS);
+    return double(bytes) / (double(timer.nsecsElapsed()) / 1000.0);
+}
+
+static bool syncToDisk(QFile &f) {
+    if (!f.flush()) return false;
+#ifdef Q_OS_WIN
+    return FlushFileBuffers(HANDLE(_get_osfhandle(f.handle()))) != 0;
+#else
+    return ::fsync(f.handle()) == 0;
+#endif
+}
+
+// 写 4KB 并强制落盘的延迟，取多次中的最小值；考试端需要写日志和缓存，机械硬盘会明显拖慢启动
+static double measureStorageWriteMs(const QString &dir) {
+    if (!QDir().mkpath(dir)) return 0;
+    QFile f(dir + "/probe.tmp");
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) return 0;
+    const QByteArray block(STORAGE_WRITE_BYTES, 'z');
+    double best = 0;
+    QElapsedTimer total;
+    total.start();
+    for (int i = 0; i < STORAGE_MAX_WRITES && total.elapsed() < STORAGE_BUDGET_MS; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        if (!f.seek(0) || f.write(block) != block.size() || !syncToDisk(f)) break;
+        const double ms = double(timer.nsecsElapsed()) / 1e6;
+        if (best == 0 || ms < best) best = ms;
+    }
+    f.close();
+    f.remove();
+    return best;
+}
+
+static void scoreCapability(SystemInfo &info) {
+    const double cpu = qBound(0.0, info.cpuMops / REF_CPU_MOPS, 2.0);
+    const double cores = qBound(0.0, double(qMax(1, info.cpuCores)) / REF_CORES, 2.0);
+    const double memory = qBound(0.0, info.memoryMBps / REF_MEMORY_MBPS, 2.0);
+    const double storage = info.storageWriteMs > 0 ? qBound(0.0, REF_STORAGE_WRITE_MS / info.storageWriteMs, 2.0) : 0.5;
+    info.capabilityScore = qRound(100.0 * (0.45 * cpu + 0.20 * cores + 0.25 * memory + 0.10 * storage));
+
+    info.isOldCpu = info.capabilityScore < LOW_PROFILE_SCORE;
+    if (info.isOldCpu) info.profile = ProfileLow;
+    else if (info.capabilityScore >= HIGH_PROFILE_SCORE && !info.lowMemory) info.profile = ProfileHigh;
+    else info.profile = ProfileStandard;
+}
+
+static void measureCapability(SystemInfo &info) {
+    info.cpuMops = measureCpuMops();
+    info.memoryMBps = measureMemoryMBps();
+    scoreCapability(info);
+}
+
+// 硬件标识部分（注册表、/proc 等），不运行微基准
+static SystemInfo detectIdentity() {
+    SystemInfo info;
+
+#ifdef Q_OS_WIN
+    // 检测Windows版本
+    QString winVer = QSysInfo::productVersion();
+    info.isOldWin = winVer.startsWith("6.0") || winVer.startsWith("6.1") || winVer.startsWith("5.");
+
+    info.cpuCores = QThread::idealThreadCount();
+    if(info.isOldWin) {
+        // 检测内存
+        MEMORYSTATUSEX memStatus;
+        memStatus.dwLength = sizeof(memStatus);
+        GlobalMemoryStatusEx(&memStatus);
+        info.totalMemoryMB = memStatus.ullTotalPhys / (1024 * 1024);
+        info.lowMemory = info.totalMemoryMB <= 4096;
+
+        // 检测CPU信息（只执行一次）
+        HKEY hKey;
+        if (RegOpenKeyExA(HKEY_LOCAL_MACHINE,
+                          "HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0",
+                          0, KEY_READ, &hKey) == ERROR_SUCCESS) {
+            DWORD dataSize = 256;
+            char data[256];
+            if (RegQueryValueExA(hKey, "ProcessorNameString", NULL, NULL,
+                                (LPBYTE)data, &dataSize) == ERROR_SUCCESS) {
+                info.cpuInfo = QString::fromLocal8Bit(data).trimmed();
+            }
+            RegCloseKey(hKey);
+        }
+
+        // 检测是否为虚拟化环境
+        if (info.cpuInfo.contains("Virtual", Qt::CaseInsensitive) ||
+            info.cpuInfo.contains("QEMU", Qt::CaseInsensitive) ||
+            info.cpuInfo.contains("VMware", Qt::CaseInsensitive) ||
+            info.cpuInfo.contains("VirtualBox", Qt::CaseInsensitive)) {
+            info.isVirtualized = true;
+        }
+    }
+#elif defined(Q_OS_LINUX)
+    // 内存：物理内存与 cgroup 上限取较小值
+    const QByteArray selfCgroup = readProcFile("/proc/self/cgroup");
+    info.totalMemoryMB = meminfoMB(readProcFile("/proc/meminfo"), "MemTotal:");
+    const quint64 limitMB = cgroupMemoryLimitMB(selfCgroup);
+    if (limitMB > 0 && (info.totalMemoryMB == 0 || limitMB < info.totalMemoryMB)) info.totalMemoryMB = limitMB;
+    info.lowMemory = info.totalMemoryMB > 0 && info.totalMemoryMB <= LOW_MEMORY_THRESHOLD_MB;
+
+    // CPU：x86 读 model name 与 hypervisor 标志，ARM 按 implementer/part 统计核心类型
+    const QByteArray cpuinfo = readProcFile("/proc/cpuinfo");
+    QString modelName, hardware;
+    bool hypervisorFlag = false;
+    int implementer = -1;
+    int processors = 0;
+    QMap<QString, int> armCores;
+    for (const QByteArray &line : cpuinfo.split('\n')) {
+        const int colon = line.indexOf(':');
+        if (colon < 0) continue;
+        const QByteArray key = line.left(colon).trimmed();
+        const QByteArray value = line.mid(colon + 1).trimmed();
+        if (key == "processor") {
+            ++processors;
+        } else if (key == "model name" && modelName.isEmpty()) {
+            modelName = QString::fromUtf8(value);
+        } else if (key == "Hardware" && hardware.isEmpty()) {
+            hardware = QString::fromUtf8(value);
+        } else if (key == "flags" && !hypervisorFlag) {
+            hypervisorFlag = (" " + value + " ").contains(" hypervisor ");
+        } else if (key == "CPU implementer") {
+            implementer = value.toInt(nullptr, 16);
+        } else if (key == "CPU part") {
+            const int part = value.toInt(nullptr, 16);
+            const ArmCore *core = findArmCore(implementer, part);
+            armCores[core ? QString::fromLatin1(core->name) : QString("0x%1").arg(part, 3, 16, QChar('0'))]++;
+        }
+    }
+
+    info.cpuCores = processors > 0 ? processors : QThread::idealThreadCount();
+    const int cpuLimit = cgroupCpuLimit(selfCgroup);
+    if (cpuLimit > 0 && cpuLimit < info.cpuCores) info.cpuCores = cpuLimit;
+
+    if (!armCores.isEmpty()) {
+        QStringList cores;
+        for (auto it = armCores.constBegin(); it != armCores.constEnd(); ++it)
+            cores << QString("%1×%2").arg(it.key()).arg(it.value());
+        info.cpuInfo = (hardware.isEmpty() ? modelName : hardware);
+        info.cpuInfo = (info.cpuInfo.isEmpty() ? QString("ARM") : info.cpuInfo) + " (" + cores.join(", ") + ")";
+    } else if (!modelName.isEmpty()) {
+        info.cpuInfo = modelName;
+    }
+
+    info.virtualization = detectVirtualization(hypervisorFlag);
+    info.isVirtualized = !info.virtualization.isEmpty();
+#endif
+    return info;
+}
+
+SystemInfo detectSystemInfo() {
+    SystemInfo info = detectIdentity();
+    measureCapability(info);
+    return info;
+}
+
+qint64 availableMemoryMB() {
+#ifdef Q_OS_WIN
+    MEMORYSTATUSEX memStatus;
+    memStatus.dwLength = sizeof(memStatus);
+    if (!GlobalMemoryStatusEx(&memStatus)) return -1;
+    return qint64(memStatus.ullAvailPhys / (1024 * 1024));
+#elif defined(Q_OS_LINUX)
+    const quint64 available = meminfoMB(readProcFile("/proc/meminfo"), "MemAvailable:");
+    if (available == 0) return -1;
+    // 容器内以 cgroup 剩余额度为准
+    const QByteArray selfCgroup = readProcFile("/proc/self/cgroup");
+    const quint64 limitMB = cgroupMemoryLimitMB(selfCgroup);
+    if (limitMB == 0) return qint64(available);
+    const quint64 usedMB = cgroupMemoryUsageMB(selfCgroup);
+    return qint64(qMin(available, limitMB > usedMB ? limitMB - usedMB : quint64(0)));
+#else
+    return -1;
+#endif
+}
+
+// --------------------------- 探测结果缓存 ---------------------------
+// 探测结果按机器指纹缓存到用户缓存目录，后续启动直接读取。指纹只取无需探测即可得到的信息
+// （主机名、内核版本、架构、逻辑核心数，Linux 另加 machine-id），硬件在指纹不变的情况下
+// 发生变化（如虚拟机迁移）由后台重新探测发现并更新缓存。
+static const quint32 PROBE_CACHE_MAGIC = 0x5A445349;   // "ZDSI"
+static const quint16 PROBE_CACHE_VERSION = 2;
+
+static QString probeCachePath() {
+    // QApplication 创建前应用名尚未设置，使用通用缓存目录下的固定子目录
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+           + "/zdf-exam-desktop/sysinfo.cache";
+}
+
+static QByteArray machineFingerprint() {
+    QByteArray key = QSysInfo::machineHostName().toUtf8() + '|' + QSysInfo::kernelType().toUtf8() + '|'
+                   + QSysInfo::kernelVersion().toUtf8() + '|' + QSysInfo::currentCpuArchitecture().toUtf8() + '|'
+                   + QByteArray::number(QThread::idealThreadCount());
+#ifdef Q_OS_LINUX
+    QFile id("/etc/machine-id");
+    if (id.open(QIODevice::ReadOnly)) key += '|' + id.readAll().trimmed();
+#endif
+    return QCryptographicHash::hash(key, QCryptographicHash::Sha1);
+}
+
+// 硬件标识字段：后台重新探测时只比较这些字段，基准测量值的正常波动不触发缓存更新
+static QByteArray identityFields(const SystemInfo &info) {
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << info.isOldWin << info.lowMemory << info.isVirtualized
+        << info.cpuInfo << qint32(info.cpuCores) << quint64(info.totalMemoryMB);
+#if !defined(Q_OS_WIN)
+    out << info.virtualization;
+#endif
+    return data;
+}
+
+// 只序列化探测得到的字段（不含来源和耗时）
+static QByteArray serializeFields(const SystemInfo &info) {
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << info.isOldWin << info.lowMemory << info.isOldCpu << info.isVirtualized
+        << info.cpuInfo << qint32(info.cpuCores) << quint64(info.totalMemoryMB);
+#if !defined(Q_OS_WIN)
+    out << info.virtualization;
+#endif
+    out << info.cpuMops << info.memoryMBps << info.storageWriteMs
+        << qint32(info.capabilityScore) << quint8(info.profile);
+    return data;
+}
+
+static bool deserializeFields(const QByteArray &data, SystemInfo &info) {
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_6);
+    quint64 totalMemoryMB = 0;
+    qint32 cpuCores = 0, score = 0;
+    quint8 profile = ProfileStandard;
+    in >> info.isOldWin >> info.lowMemory >> info.isOldCpu >> info.isVirtualized
+       >> info.cpuInfo >> cpuCores >> totalMemoryMB;
+#if !defined(Q_OS_WIN)
+    in >> info.virtualization;
+#endif
+    in >> info.cpuMops >> info.memoryMBps >> info.storageWriteMs >> score >> profile;
+    info.cpuCores = cpuCores;
+    info.totalMemoryMB = totalMemoryMB;
+    info.capabilityScore = score;
+    info.profile = CapabilityProfile(qMin<quint8>(profile, ProfileHigh));
+    return in.status() == QDataStream::Ok && in.atEnd();
+}
+
+static bool readProbeCache(const QByteArray &fingerprint, SystemInfo &info) {
+    QFile f(probeCachePath());
+    if (!f.open(QIODevice::ReadOnly)) return false;
+    QDataStream in(&f);
+    in.setVersion(QDataStream::Qt_5_6);
+    quint32 magic = 0; quint16 version = 0;
+    QByteArray cachedFingerprint, fields;
+    in >> magic >> version;
+    if (magic != PROBE_CACHE_MAGIC || version != PROBE_CACHE_VERSION) return false;
+    in >> cachedFingerprint >> fields;
+    return in.status() == QDataStream::Ok && cachedFingerprint == fingerprint && deserializeFields(fields, info);
+}
+
+static void writeProbeCache(const QByteArray &fingerprint, const SystemInfo &info) {
+    const QString path = probeCachePath();
+    if (!QDir().mkpath(QFileInfo(path).absolutePath())) return;
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) return;
+    QDataStream out(&f);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << PROBE_CACHE_MAGIC << PROBE_CACHE_VERSION << fingerprint << serializeFields(info);
+    f.commit();
+}
+
+const SystemInfo &systemInfo() {
+    static const SystemInfo info = []() {
+        QElapsedTimer timer;
+        timer.start();
+        const QByteArray fingerprint = machineFingerprint();
+        SystemInfo result;
+        if (readProbeCache(fingerprint, result)) {
+            result.fromCache = true;
+        } else {
+            result = detectSystemInfo();
+            writeProbeCache(fingerprint, result);
+        }
+        result.probeMs = double(timer.nsecsElapsed()) / 1e6;
+        return result;
+    }();
+    return info;
+}
+
+// 后台低优先级运行，与考试页面加载同时进行，因此不跑 CPU/内存微基准：
+// - 结果取自缓存时只重新读取硬件标识，与缓存不同则删除缓存，下次启动重新探测并评分
+// - 尚未测得落盘延迟时测量一次，重新计算评分后写入缓存，下次启动生效
+class SystemProbeThread : public QThread {
+public:
+    SystemProbeThread() { setObjectName("SystemProbe"); }
+protected:
+    void run() override {
+        const SystemInfo &current = systemInfo();
+        if (current.fromCache) {
+            const SystemInfo fresh = detectIdentity();
+            if (identityFields(fresh) != identityFields(current)) {
+                QFile::remove(probeCachePath());
+                ZDF_LOG_APP(L_WARNING, "硬件信息与缓存不一致，已删除缓存，下次启动重新探测 - CPU：%1，内存：%2MB",
+                            fresh.cpuInfo, quint64(fresh.totalMemoryMB));
+                return;
+            }
+        }
+        if (current.storageWriteMs > 0) return;
+
+        SystemInfo updated = current;
+        updated.storageWriteMs = measureStorageWriteMs(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+                                                       + "/zdf-exam-desktop");
+        if (updated.storageWriteMs <= 0) return;
+        scoreCapability(updated);
+        writeProbeCache(machineFingerprint(), updated);
+        ZDF_LOG_APP(L_INFO, "磁盘落盘延迟 %1 ms，性能评分 %2 → %3，下次启动生效",
+                    updated.storageWriteMs, current.capabilityScore, updated.capabilityScore);
+    }
+};
+
+void revalidateSystemInfoCache() {
+    if (!systemInfo().fromCache && systemInfo().storageWriteMs > 0) return;
+    SystemProbeThread *thread = new SystemProbeThread;
+    QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    thread->start(QThread::LowestPriority);
+}
@@ -0,0 +1,54 @@
+#ifndef ZDF_SYSINFO_H
+#define ZDF_SYSINFO_H
+
+#include <QString>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+// 按性能评分划分的机器档位
+enum CapabilityProfile : quint8 { ProfileLow, ProfileStandard, ProfileHigh };
+
+// --------------------------- 系统信息检测结构体 ---------------------------
+// lowMemory / isOldCpu / isVirtualized 驱动 ShellBrowser 和 main 中的低配置优化路径
+struct SystemInfo {
+    bool isOldWin = false;
+    bool lowMemory = false;
+    bool isOldCpu = false;
+    bool isVirtualized = false;
+    QString cpuInfo = "Unknown";
+    int cpuCores = 0;               // 可用核心数，Linux 下已按 cgroup CPU 配额取较小值
+#ifdef Q_OS_WIN
+    DWORDLONG totalMemoryMB = 0;
+#else
+    quint64 totalMemoryMB = 0;      // 已按 cgroup 内存上限取较小值
+    QString virtualization;         // 检测到的虚拟化平台，空表示物理机
+#endif
+
+    // 启动微基准（CPU、内存合计约 50 毫秒）的原始测量值与评分，isOldCpu 由评分决定
+    double cpuMops = 0;             // 单线程整数运算吞吐（百万次/秒）
+    double memoryMBps = 0;          // 内存拷贝带宽（MB/秒）
+    double storageWriteMs = 0;      // 4KB 写入并落盘的延迟（毫秒），在后台测量后写入缓存，0 表示尚未测得
+    int capabilityScore = 0;        // 参考机器约为 100
+    CapabilityProfile profile = ProfileStandard;
+    bool fromCache = false;         // 取自磁盘缓存（本次启动未探测）
+    double probeMs = 0;             // 取得该结果的耗时
+};
+
+// 实际探测（读注册表、/proc 等，并运行 CPU/内存微基准），一般不直接调用
+SystemInfo detectSystemInfo();
+
+// 当前可用物理内存（MB），Linux 下已按 cgroup 剩余额度取较小值；无法获取时返回 -1。
+// 每次调用实时读取，开销很小，可用于定时检查
+qint64 availableMemoryMB();
+
+// 进程内唯一的系统信息：首次调用时按机器指纹查找磁盘缓存，命中则跳过探测，
+// 否则探测并写入缓存。可在 QApplication 创建前调用
+const SystemInfo &systemInfo();
+
+// 后台线程中：结果取自缓存时重新读取硬件标识，变化时删除缓存；尚未测得落盘延迟时测量并更新缓存。
+// 均在下次启动生效。需在 QCoreApplication 创建后调用
+void revalidateSystemInfoCache();
+
+#endif // ZDF_SYSINFO_H
@@ -0,0 +1,135 @@
+#include "timeline.h"
+#include "logger.h"
+
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStringList>
+#include <QSysInfo>
+#include <QDateTime>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#elif defined(Q_OS_LINUX)
+#include <QFile>
+#include <unistd.h>
+#endif
+
+// --------------------------- 进程创建时刻 ---------------------------
+// main 之前的耗时（加载器、DLL/共享库初始化、静态构造），取自操作系统记录的进程创建时间
+static qint64 processAgeNs() {
+#ifdef Q_OS_WIN
+    FILETIME creation, exitTime, kernel, user, now;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exitTime, &kernel, &user)) return 0;
+    GetSystemTimeAsFileTime(&now);
+    const quint64 c = (quint64(creation.dwHighDateTime) << 32) | creation.dwLowDateTime;
+    const quint64 n = (quint64(now.dwHighDateTime) << 32) | now.dwLowDateTime;
+    return n > c ? qint64(n - c) * 100 : 0;     // FILETIME 单位为 100 纳秒
+#elif defined(Q_OS_LINUX)
+    // /proc/self/stat 第 22 项为进程启动时刻（开机后的时钟滴答数），精度通常为 10 毫秒
+    QFile stat("/proc/self/stat"), uptime("/proc/uptime");
+    if (!stat.open(QIODevice::ReadOnly) || !uptime.open(QIODevice::ReadOnly)) return 0;
+    const QByteArray statLine = stat.readAll();
+    const QList<QByteArray> fields = statLine.mid(statLine.lastIndexOf(')') + 2).split(' ');
+    const long ticks = sysconf(_SC_CLK_TCK);
+    if (fields.size() < 20 || ticks <= 0) return 0;
+    const double startSec = fields.at(19).toDouble() / double(ticks);
+    const double nowSec = uptime.readAll().split(' ').value(0).toDouble();
+    return nowSec > startSec ? qint64((nowSec - startSec) * 1e9) : 0;
+#else
+    return 0;
+#endif
+}
+
+// --------------------------- StartupTimeline ---------------------------
+static const qint64 MAX_PRE_MAIN_NS = 60LL * 1000 * 1000 * 1000;   // 超出视为时钟异常，不计入
+
+StartupTimeline::StartupTimeline() {
+    m_clock.start();
+    const qint64 age = processAgeNs();
+    m_processStartNs = (age > 0 && age < MAX_PRE_MAIN_NS) ? -age : 0;
+    m_events.reserve(64);
+}
+
+int StartupTimeline::begin(const char *phase) {
+    if (m_finished) return -1;
+    m_events.push_back(Event{phase, m_clock.nsecsElapsed(), 0, QString(), true});
+    return int(m_events.size()) - 1;
+}
+
+void StartupTimeline::end(int span, const QString &detail) {
+    if (m_finished || span < 0 || span >= int(m_events.size())) return;
+    Event &e = m_events[span];
+    e.durationNs = m_clock.nsecsElapsed() - e.startNs;
+    e.detail = detail;
+}
+
+void StartupTimeline::mark(const char *phase, const QString &detail, bool inSummary) {
+    if (m_finished) return;
+    m_events.push_back(Event{phase, m_clock.nsecsElapsed(), -1, detail, inSummary});
+}
+
+void StartupTimeline::finish(const QString &tracePath) {
+    if (m_finished) return;
+    m_finished = true;
+    const qint64 endNs = m_clock.nsecsElapsed();
+
+    QStringList parts;
+    if (m_processStartNs < 0) parts << QString("main之前 %1 ms").arg(double(-m_processStartNs) / 1e6, 0, 'f', 0);
+    for (const Event &e : m_events) {
+        if (!e.inSummary) continue;
+        if (e.durationNs >= 0) parts << QString("%1 %2 ms").arg(QLatin1String(e.name)).arg(double(e.durationNs) / 1e6, 0, 'f', 1);
+        else parts << QString("%1 @%2 ms").arg(QLatin1String(e.name)).arg(double(e.startNs) / 1e6, 0, 'f', 0);
+    }
+    ZDF_LOG_EVENT(CatStartup, L_INFO, "启动时间线：总计 %1 ms（自进程创建），%2",
+                  double(endNs - m_processStartNs) / 1e6, parts.join("，"));
+
+    if (tracePath.isEmpty()) return;
+    if (writeTrace(tracePath)) ZDF_LOG_EVENT(CatStartup, L_INFO, "启动时间线已导出：%1", tracePath);
+    else ZDF_LOG_EVENT(CatStartup, L_WARNING, "启动时间线导出失败：%1", tracePath);
+}
+
+// Chrome trace-event 格式：阶段为 "X"（完整事件），瞬时事件为 "i"，时间单位微秒。
+// 时间以进程创建为零点，避免出现负的时间戳
+bool StartupTimeline::writeTrace(const QString &path) const {
+    const int pid = int(QCoreApplication::applicationPid());
+    auto micros = [this](qint64 ns) { return double(ns - m_processStartNs) / 1000.0; };
+
+    QJsonArray events;
+    events.append(QJsonObject{{"name", "process_name"}, {"ph", "M"}, {"pid", pid}, {"tid", 1},
+                              {"args", QJsonObject{{"name", QCoreApplication::applicationName()}}}});
+    if (m_processStartNs < 0) {
+        events.append(QJsonObject{{"name", "pre-main"}, {"cat", "startup"}, {"ph", "X"}, {"pid", pid}, {"tid", 1},
+                                  {"ts", 0}, {"dur", double(-m_processStartNs) / 1000.0}});
+    }
+    for (const Event &e : m_events) {
+        QJsonObject ev{{"name", QLatin1String(e.name)}, {"cat", "startup"}, {"pid", pid}, {"tid", 1},
+                       {"ts", micros(e.startNs)}};
+        if (e.durationNs >= 0) {
+            ev.insert("ph", "X");
+            ev.insert("dur", double(e.durationNs) / 1000.0);
+        } else {
+            ev.insert("ph", "i");
+            ev.insert("s", "p");
+        }
+        if (!e.detail.isEmpty()) ev.insert("args", QJsonObject{{"detail", e.detail}});
+        events.append(ev);
+    }
+
+    const QJsonObject root{
+        {"traceEvents", events},
+        {"displayTimeUnit", "ms"},
+        {"otherData", QJsonObject{{"qtVersion", QLatin1String(qVersion())},
+                                  {"os", QSysInfo::prettyProductName()},
+                                  {"cpuArchitecture", QSysInfo::currentCpuArchitecture()},
+                                  {"startedAt", QDateTime::currentDateTime().addMSecs(
+                                       -(m_clock.elapsed() - m_processStartNs / 1000000)).toString(Qt::ISODate)}}}
+    };
+
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) return false;
+    f.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return f.commit();
+}
@@ -0,0 +1,51 @@
+#ifndef ZDF_TIMELINE_H
+#define ZDF_TIMELINE_H
+
+#include <QString>
+#include <QElapsedTimer>
+
+#include <vector>
+
+// --------------------------- 启动时间线 ---------------------------
+// 记录启动各阶段的起止时间（以进入 main 为零点），页面首次绘制后结束：
+// startup.log 写一条汇总，启用 log.startupTrace 时另存 Chrome trace-event JSON，
+// 可在 chrome://tracing 或 Perfetto 中打开对比不同机器和版本。
+// 只在 GUI 线程（及 QApplication 创建前的主线程）调用，不加锁。
+class StartupTimeline {
+public:
+    static StartupTimeline& instance(){ static StartupTimeline t; return t; }
+
+    // 阶段开始，返回交给 end() 的编号
+    int begin(const char *phase);
+    void end(int span, const QString &detail = QString());
+
+    // 瞬时事件；inSummary 为 false 的只写入 trace 文件（如逐次的加载进度）
+    void mark(const char *phase, const QString &detail = QString(), bool inSummary = true);
+
+    qint64 elapsedMs() const { return m_clock.elapsed(); }
+    bool isFinished() const { return m_finished; }
+
+    // 结束记录：汇总写入 startup.log，tracePath 非空时写 trace 文件。重复调用无效
+    void finish(const QString &tracePath = QString());
+
+private:
+    StartupTimeline();
+    StartupTimeline(const StartupTimeline&)=delete; StartupTimeline& operator=(const StartupTimeline&)=delete;
+
+    struct Event {
+        const char *name;
+        qint64 startNs;
+        qint64 durationNs;      // -1 表示瞬时事件
+        QString detail;
+        bool inSummary;
+    };
+
+    bool writeTrace(const QString &path) const;
+
+    QElapsedTimer m_clock;
+    qint64 m_processStartNs;    // 进程创建时刻相对 main 的偏移（负数），无法获取时为 0
+    std::vector<Event> m_events;
+    bool m_finished{false};
+};
+
+#endif // ZDF_TIMELINE_H
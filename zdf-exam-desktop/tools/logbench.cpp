@@ -0,0 +1,265 @@
+// zdf-logbench：日志吞吐与调用延迟基准，结果以 JSON 输出，便于跨版本对比
+//   zdf-logbench [-n 每线程调用次数] [-t 线程数列表，如 2,4,8] [-o 结果.json]
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QDateTime>
+#include <QThread>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "../logger.h"
+
+// 统计全进程堆分配次数，用于验证稳态日志调用不分配内存
+static std::atomic<quint64> g_allocations{0};
+
+void *operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+// --------------------------- 场景定义 ---------------------------
+enum CallKind { CallDeferred, CallEagerFormat, CallFixedMessage };
+enum FlushPolicy { FlushBatched, FlushPerCall };
+
+struct Scenario {
+    QByteArray name;
+    int threads;
+    LogLevel level;         // 调用使用的级别（WARNING 及以上会立即唤醒写线程）
+    LogLevel threshold;     // 运行期日志级别
+    CallKind call;
+    bool mixedSinks;        // 轮流写入 app/config/exit/startup 四个文件
+    FlushPolicy flush;
+    bool binary;
+};
+
+static const LogCategory MIXED_CATEGORIES[] = {CatApp, CatConfig, CatHotkey, CatStartup};
+static const char *const LEVEL_NAMES[] = {"DEBUG", "INFO", "WARNING", "ERROR"};
+static const char *const CALL_NAMES[] = {"deferred", "eagerFormat", "fixedMessage"};
+static const int WAIT_WRITTEN_TIMEOUT_MS = 30000;
+
+struct ThreadResult {
+    std::vector<quint32> latencyNs;
+};
+
+static void runCalls(const Scenario &sc, int iterations, ThreadResult &result) {
+    Logger &logger = Logger::instance();
+    const QString fixedMessage = QStringLiteral("按键事件: Ctrl+Shift+A");
+    std::vector<quint32> &lat = result.latencyNs;
+    for (int i = 0; i < iterations; ++i) {
+        const LogCategory cat = sc.mixedSinks ? MIXED_CATEGORIES[i & 3] : CatApp;
+        const auto t0 = std::chrono::steady_clock::now();
+        switch (sc.call) {
+        case CallDeferred:
+            if (sc.level == L_DEBUG) ZDF_LOG_EVENT(cat, L_DEBUG, "基准测试 %1 / %2", i, 3.5);
+            else ZDF_LOG_EVENT(cat, sc.level, "基准测试 %1 / %2", i, 3.5);
+            break;
+        case CallEagerFormat:
+            logger.logEvent(cat, QString("按键事件: %1").arg(i), sc.level);
+            break;
+        case CallFixedMessage:
+            logger.logEvent(cat, fixedMessage, sc.level);
+            break;
+        }
+        if (sc.flush == FlushPerCall) logger.flushAllLogBuffers();
+        const auto t1 = std::chrono::steady_clock::now();
+        const qint64 ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+        lat[size_t(i)] = quint32(qMin<qint64>(ns, 0xFFFFFFFF));
+    }
+}
+
+// 等待写线程把目标条数全部写入文件（或计入丢弃）
+static bool waitWritten(quint64 target) {
+    Logger &logger = Logger::instance();
+    QElapsedTimer timer;
+    timer.start();
+    while (logger.entriesWritten() + logger.droppedCount() < target) {
+        if (timer.elapsed() > WAIT_WRITTEN_TIMEOUT_MS) return false;
+        logger.flushAllLogBuffers();
+        QThread::msleep(1);
+    }
+    return true;
+}
+
+static quint32 percentile(const std::vector<quint32> &sorted, double p) {
+    if (sorted.empty()) return 0;
+    return sorted[qMin(sorted.size() - 1, size_t(double(sorted.size()) * p))];
+}
+
+static QJsonObject runScenario(const Scenario &sc, int iterations) {
+    Logger &logger = Logger::instance();
+    logger.setLogLevel(sc.threshold);
+    logger.setBinaryFormat(sc.binary);
+
+    const bool enabled = sc.level >= ZDF_LOG_MIN_LEVEL && sc.level >= sc.threshold;
+    const quint64 calls = quint64(iterations) * quint64(sc.threads);
+    const quint64 writtenBefore = logger.entriesWritten();
+    const quint64 droppedBefore = logger.droppedCount();
+    const quint64 bytesBefore = logger.bytesWritten();
+    const quint64 overflowBefore = logger.overflowCount();
+
+    // 延迟数组在计时前分配好，测量区间内的分配只来自日志调用本身
+    std::vector<ThreadResult> results(size_t(sc.threads));
+    for (ThreadResult &r : results) r.latencyNs.resize(size_t(iterations));
+
+    QElapsedTimer wall;
+    quint64 allocs = 0;
+    if (sc.threads == 1) {
+        const quint64 allocBefore = g_allocations.load();
+        wall.start();
+        runCalls(sc, iterations, results[0]);
+        allocs = g_allocations.load() - allocBefore;
+    } else {
+        std::atomic<bool> go{false};
+        std::vector<std::thread> workers;
+        workers.reserve(size_t(sc.threads));
+        for (int t = 0; t < sc.threads; ++t) {
+            workers.emplace_back([&sc, iterations, &results, &go, t]() {
+                while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+                runCalls(sc, iterations, results[size_t(t)]);
+            });
+        }
+        wall.start();
+        go.store(true, std::memory_order_release);
+        for (std::thread &w : workers) w.join();
+    }
+    const double callNs = double(wall.nsecsElapsed());
+    const bool drained = waitWritten(writtenBefore + droppedBefore + (enabled ? calls : 0));
+    const double endToEndNs = double(wall.nsecsElapsed());
+
+    std::vector<quint32> all;
+    all.reserve(size_t(calls));
+    for (const ThreadResult &r : results) all.insert(all.end(), r.latencyNs.begin(), r.latencyNs.end());
+    std::sort(all.begin(), all.end());
+
+    const quint64 written = logger.entriesWritten() - writtenBefore;
+    QJsonObject latency{
+        {"p50", double(percentile(all, 0.50))},
+        {"p99", double(percentile(all, 0.99))},
+        {"max", double(all.empty() ? 0 : all.back())}
+    };
+    QJsonObject obj{
+        {"name", QString::fromLatin1(sc.name)},
+        {"threads", sc.threads},
+        {"level", LEVEL_NAMES[sc.level]},
+        {"threshold", LEVEL_NAMES[sc.threshold]},
+        {"call", CALL_NAMES[sc.call]},
+        {"sinks", sc.mixedSinks ? "mixed" : "app"},
+        {"flush", sc.flush == FlushPerCall ? "perCall" : (sc.level >= L_WARNING ? "urgent" : "batched")},
+        {"format", sc.binary ? "binary" : "text"},
+        {"calls", double(calls)},
+        {"callsPerSec", callNs > 0 ? double(calls) * 1e9 / callNs : 0.0},
+        {"entriesPerSec", enabled && endToEndNs > 0 ? double(written) * 1e9 / endToEndNs : 0.0},
+        {"latencyNs", latency},
+        {"entriesWritten", double(written)},
+        {"bytesWritten", double(logger.bytesWritten() - bytesBefore)},
+        {"dropped", double(logger.droppedCount() - droppedBefore)},
+        {"overflow", double(logger.overflowCount() - overflowBefore)},
+        {"drained", drained}
+    };
+    if (sc.threads == 1) obj.insert("allocsPerCall", double(allocs) / double(calls));
+    return obj;
+}
+
+// 计时本身的开销，用于解读单次调用延迟
+static double timerOverheadNs() {
+    const int samples = 100000;
+    const auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < samples; ++i) (void)std::chrono::steady_clock::now();
+    const auto end = std::chrono::steady_clock::now();
+    return double(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()) / samples;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    args.removeFirst();
+
+    int iterations = 20000;
+    QList<int> threadCounts{2, 4, 8};
+    QString outputPath;
+    for (int i = 0; i < args.size(); ++i) {
+        const QString &a = args.at(i);
+        if (a == "-n" && i + 1 < args.size()) {
+            iterations = qMax(1, args.at(++i).toInt());
+        } else if (a == "-t" && i + 1 < args.size()) {
+            threadCounts.clear();
+            for (const QString &t : args.at(++i).split(','))
+                if (t.toInt() > 1) threadCounts << t.toInt();
+        } else if (a == "-o" && i + 1 < args.size()) {
+            outputPath = args.at(++i);
+        } else {
+            fprintf(stderr, "用法: zdf-logbench [-n 每线程调用次数] [-t 线程数列表] [-o 结果.json]\n");
+            return 2;
+        }
+    }
+
+    // 单线程：过滤路径、各级别、单文件/多文件、批量/立即/逐条刷新、文本/二进制
+    QList<Scenario> scenarios{
+        {"filtered_deferred",       1, L_INFO,    L_WARNING, CallDeferred,     false, FlushBatched, false},
+        {"filtered_eager",          1, L_INFO,    L_WARNING, CallEagerFormat,  false, FlushBatched, false},
+        {"compiled_out_debug",      1, L_DEBUG,   L_WARNING, CallDeferred,     false, FlushBatched, false},
+        {"info_deferred_app",       1, L_INFO,    L_INFO,    CallDeferred,     false, FlushBatched, false},
+        {"info_fixed_app",          1, L_INFO,    L_INFO,    CallFixedMessage, false, FlushBatched, false},
+        {"info_eager_app",          1, L_INFO,    L_INFO,    CallEagerFormat,  false, FlushBatched, false},
+        {"info_deferred_mixed",     1, L_INFO,    L_INFO,    CallDeferred,     true,  FlushBatched, false},
+        {"warning_deferred_mixed",  1, L_WARNING, L_INFO,    CallDeferred,     true,  FlushBatched, false},
+        {"info_deferred_flush",     1, L_INFO,    L_INFO,    CallDeferred,     false, FlushPerCall, false},
+        {"info_deferred_binary",    1, L_INFO,    L_INFO,    CallDeferred,     true,  FlushBatched, true},
+    };
+    // 多线程：多个生产者同时写入多个文件
+    for (int threads : threadCounts) {
+        const QByteArray prefix = "mt" + QByteArray::number(threads);
+        scenarios << Scenario{prefix + "_info_deferred_mixed", threads, L_INFO, L_INFO, CallDeferred, true, FlushBatched, false};
+        scenarios << Scenario{prefix + "_warning_deferred_mixed", threads, L_WARNING, L_INFO, CallDeferred, true, FlushBatched, false};
+    }
+
+    QJsonArray results;
+    for (const Scenario &sc : scenarios) {
+        fprintf(stderr, "运行 %s ...\n", sc.name.constData());
+        results.append(runScenario(sc, iterations));
+    }
+    Logger::instance().shutdown();
+
+    QJsonObject report{
+        {"tool", "zdf-logbench"},
+        {"timestamp", QDateTime::currentDateTimeUtc().toString(Qt::ISODate)},
+        {"qtVersion", qVersion()},
+#ifdef QT_NO_DEBUG
+        {"buildType", "release"},
+#else
+        {"buildType", "debug"},
+#endif
+        {"minLevel", ZDF_LOG_MIN_LEVEL},
+        {"cpuCount", QThread::idealThreadCount()},
+        {"iterationsPerThread", iterations},
+        {"timerOverheadNs", timerOverheadNs()},
+        {"scenarios", results}
+    };
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+
+    if (outputPath.isEmpty()) {
+        fwrite(json.constData(), 1, size_t(json.size()), stdout);
+    } else {
+        QFile file(outputPath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+            fprintf(stderr, "无法写入文件: %s\n", qPrintable(outputPath));
+            return 1;
+        }
+    }
+    return 0;
+}
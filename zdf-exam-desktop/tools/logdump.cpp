@@ -0,0 +1,102 @@
+// zdf-logdump：把二进制日志（*.zlog）还原为与文本日志相同的格式
+//   zdf-logdump [--level] [-o 输出文件] <app.zlog> [更多文件...]
+#include <QCoreApplication>
+#include <QStringList>
+#include <QFile>
+#include <QHash>
+#include <QDateTime>
+#include <QTextStream>
+
+#include <cstdio>
+
+#include "../logformat.h"
+
+static const char *LEVEL_NAMES[] = {"DEBUG", "INFO", "WARNING", "ERROR"};
+
+static bool dumpFile(const QString &path, QTextStream &out, bool showLevel) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "无法打开文件: %s\n", qPrintable(path));
+        return false;
+    }
+
+    zdflog::Reader reader(file.readAll());
+    zdflog::Reader::Record rec;
+    QHash<quint16, QString> categories;
+    qint64 wallClockBaseMs = 0;
+    bool haveSession = false;
+    qint64 lastSecond = -1;
+    QString stamp;
+
+    while (reader.next(rec)) {
+        switch (rec.type) {
+        case zdflog::RecSession:
+            // 新会话（新进程或轮转后的新文件）重新建立分类表
+            wallClockBaseMs = rec.wallClockBaseMs;
+            categories.clear();
+            haveSession = true;
+            break;
+        case zdflog::RecCategory:
+            categories.insert(rec.categoryId, QString::fromUtf8(rec.text));
+            break;
+        case zdflog::RecEntry: {
+            if (!haveSession) break;
+            const qint64 second = (wallClockBaseMs + qint64(rec.timestampUs / 1000)) / 1000;
+            if (second != lastSecond) {
+                lastSecond = second;
+                stamp = QDateTime::fromMSecsSinceEpoch(second * 1000).toString("yyyy-MM-dd hh:mm:ss");
+            }
+            out << stamp << " | ";
+            if (showLevel) out << (rec.level < 4 ? LEVEL_NAMES[rec.level] : "?") << " | ";
+            out << categories.value(rec.categoryId, QString("#%1").arg(rec.categoryId))
+                << " | " << QString::fromUtf8(rec.text) << "\n";
+            break;
+        }
+        }
+    }
+
+    if (reader.truncated()) {
+        fprintf(stderr, "%s: 偏移 %d 处记录不完整，已停止解码\n", qPrintable(path), reader.offset());
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    args.removeFirst();
+
+    bool showLevel = false;
+    QString outputPath;
+    QStringList inputs;
+    for (int i = 0; i < args.size(); ++i) {
+        const QString &a = args.at(i);
+        if (a == "--level") showLevel = true;
+        else if (a == "-o" && i + 1 < args.size()) outputPath = args.at(++i);
+        else inputs << a;
+    }
+    if (inputs.isEmpty()) {
+        fprintf(stderr, "用法: zdf-logdump [--level] [-o 输出文件] <日志.zlog> [...]\n");
+        return 2;
+    }
+
+    QFile output;
+    if (outputPath.isEmpty()) {
+        output.open(stdout, QIODevice::WriteOnly);
+    } else {
+        output.setFileName(outputPath);
+        if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            fprintf(stderr, "无法写入文件: %s\n", qPrintable(outputPath));
+            return 1;
+        }
+    }
+    QTextStream out(&output);
+    out.setCodec("UTF-8");
+
+    int failures = 0;
+    for (const QString &path : inputs) {
+        if (!dumpFile(path, out, showLevel)) ++failures;
+    }
+    out.flush();
+    return failures ? 1 : 0;
+}
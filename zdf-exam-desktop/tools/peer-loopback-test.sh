@@ -0,0 +1,65 @@
+#!/bin/sh
+# 同伴共享的本机回环验证：在一台机器上模拟一个考场的几个座位
+#   tools/peer-loopback-test.sh <构建出的 zdf-exam-desktop> <资源目录> [座位数，默认 3]
+# 每个座位是一个单独的程序目录（程序副本 + config.json），HTTP 端口 47400+N，互相列为固定同伴
+# （回环网卡通常没有组播路由）。第 1 个座位先从模拟服务器下载并继续提供 30 秒，
+# 其余座位随后同时开始，应主要从同伴获取。最后比较模拟服务器的累计发送量和各座位的汇总。
+set -e
+BIN=$(realpath "$1")
+ASSETS=$(realpath "$2")
+SEATS=${3:-3}
+TOOLS=$(dirname "$(realpath "$0")")
+WORK=$(mktemp -d)
+echo "工作目录: $WORK"
+
+python3 "$TOOLS/stage-mock-server.py" "$ASSETS" --port 8000 > "$WORK/server.log" &
+SERVER=$!
+trap 'kill $SERVER 2>/dev/null' EXIT
+sleep 1
+
+for i in $(seq 1 "$SEATS"); do
+    PEERS=""
+    for j in $(seq 1 "$SEATS"); do
+        [ "$j" = "$i" ] && continue
+        PEERS="$PEERS${PEERS:+, }\"127.0.0.1:$((47400 + j))\""
+    done
+    SEED=0
+    [ "$i" = 1 ] && SEED=30
+    mkdir -p "$WORK/seat$i"
+    cp "$BIN" "$WORK/seat$i/"
+    cat > "$WORK/seat$i/config.json" <<EOF
+{
+  "url": "http://127.0.0.1:8000/",
+  "exitPassword": "loopback",
+  "appName": "seat$i",
+  "assetPack": {"path": "exam.zpack"},
+  "staging": {"manifestUrl": "http://127.0.0.1:8000/zdf-manifest.json", "directory": "staging", "bandwidthKBps": 0},
+  "peerShare": {"enabled": true, "port": $((47400 + i)), "peers": [$PEERS], "seedSec": $SEED}
+}
+EOF
+done
+
+EXE=$(basename "$BIN")
+(cd "$WORK/seat1" && "./$EXE" --stage --now > stage.out 2>&1) &
+SEED_PID=$!
+while [ ! -f "$WORK/seat1/exam.zpack" ]; do
+    kill -0 $SEED_PID 2>/dev/null || { echo "座位 1 预取失败"; cat "$WORK/seat1/stage.out"; exit 1; }
+    sleep 1
+done
+ORIGIN_SEED=$(tail -n 1 "$WORK/server.log")
+
+PIDS=""
+for i in $(seq 2 "$SEATS"); do
+    (cd "$WORK/seat$i" && "./$EXE" --stage --now > stage.out 2>&1) &
+    PIDS="$PIDS $!"
+done
+for p in $PIDS; do wait "$p" || true; done
+sleep 2
+
+echo "座位 1 完成时模拟服务器: $ORIGIN_SEED"
+echo "全部完成时模拟服务器:   $(tail -n 1 "$WORK/server.log")"
+for i in $(seq 1 "$SEATS"); do
+    echo "--- 座位 $i"
+    grep -a "同伴\|资源包已生成\|失败" "$WORK/seat$i/stage.out" | tr '\r' '\n' | grep -v "^$" | tail -n 3
+done
+wait $SEED_PID || true
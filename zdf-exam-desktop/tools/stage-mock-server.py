@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+# 考前预取的本地模拟服务器：用于在没有学校服务器时验证 --stage 的并发、限速、续传和重试
+#   python3 stage-mock-server.py <资源目录> [--port 8000] [--fail-rate 0.1] [--fail-status 0.1] [--slow-kbps 0]
+# 资源目录按服务器路径组织；/zdf-manifest.json 按目录内容即时生成（含 size 和 sha256）。
+# 支持 Range（206，If-Range 与 Last-Modified 不一致时回 200 整个文件）和 If-Modified-Since（304）；--fail-rate 按概率在发送中途断开连接，
+# 用于验证续传；--fail-status 按概率返回带 ETag/Last-Modified 的 503 错误页，用于验证错误页不会写入 .part；每秒在终端输出当前连接数、全部连接的合计发送速率和累计发送量（即源站流量）。
+import argparse
+import email.utils
+import hashlib
+import json
+import os
+import random
+import threading
+import time
+from http.server import ThreadingHTTPServer, SimpleHTTPRequestHandler
+
+MANIFEST = "/zdf-manifest.json"
+stats = {"active": 0, "peak": 0, "bytes": 0}
+lock = threading.Lock()
+
+
+def build_manifest(root, base_url):
+    files = []
+    for dirpath, _, names in os.walk(root):
+        for name in sorted(names):
+            full = os.path.join(dirpath, name)
+            with open(full, "rb") as f:
+                digest = hashlib.sha256(f.read()).hexdigest()
+            files.append({"path": os.path.relpath(full, root).replace(os.sep, "/"),
+                          "size": os.path.getsize(full), "sha256": digest})
+    return json.dumps({"baseUrl": base_url, "files": files}, ensure_ascii=False).encode("utf-8")
+
+
+class Handler(SimpleHTTPRequestHandler):
+    def do_GET(self):
+        with lock:
+            stats["active"] += 1
+            stats["peak"] = max(stats["peak"], stats["active"])
+        try:
+            self.serve()
+        finally:
+            with lock:
+                stats["active"] -= 1
+
+    def serve(self):
+        if self.path == MANIFEST:
+            body = build_manifest(self.directory, "http://%s/" % self.headers.get("Host"))
+            self.send_response(200)
+            self.send_header("Content-Type", "application/json")
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+            return
+
+        path = self.translate_path(self.path)
+        if not os.path.isfile(path):
+            self.send_error(404)
+            return
+        if random.random() < args.fail_status:
+            body = b"<html><body><h1>503 Service Unavailable</h1>" + b" " * 1000 + b"</body></html>"
+            self.send_response(503)
+            self.send_header("Content-Type", "text/html")
+            self.send_header("Content-Length", str(len(body)))
+            self.send_header("ETag", '"error-page"')
+            self.send_header("Last-Modified", email.utils.formatdate(usegmt=True))
+            self.end_headers()
+            self.wfile.write(body)
+            return
+        size = os.path.getsize(path)
+        mtime = int(os.path.getmtime(path))
+        since = self.headers.get("If-Modified-Since")
+        if since and email.utils.parsedate_to_datetime(since).timestamp() >= mtime:
+            self.send_response(304)
+            self.end_headers()
+            return
+
+        start = 0
+        rng = self.headers.get("Range")
+        if_range = self.headers.get("If-Range")
+        if if_range and if_range != email.utils.formatdate(mtime, usegmt=True):
+            rng = None      # 文件在中断后变化过：忽略 Range，整个文件重新发送
+        if rng and rng.startswith("bytes=") and rng.endswith("-"):
+            start = int(rng[6:-1])
+            if start >= size:
+                self.send_response(416)
+                self.send_header("Content-Range", "bytes */%d" % size)
+                self.end_headers()
+                return
+            self.send_response(206)
+            self.send_header("Content-Range", "bytes %d-%d/%d" % (start, size - 1, size))
+        else:
+            self.send_response(200)
+        self.send_header("Content-Type", self.guess_type(path))
+        self.send_header("Content-Length", str(size - start))
+        self.send_header("Last-Modified", email.utils.formatdate(mtime, usegmt=True))
+        self.end_headers()
+
+        cut = start + int((size - start) * random.random()) if random.random() < args.fail_rate else None
+        with open(path, "rb") as f:
+            f.seek(start)
+            pos = start
+            while pos < size:
+                chunk = f.read(16 * 1024)
+                if cut is not None and pos + len(chunk) > cut:
+                    self.wfile.write(chunk[:cut - pos])
+                    self.close_connection = True
+                    return
+                self.wfile.write(chunk)
+                pos += len(chunk)
+                with lock:
+                    stats["bytes"] += len(chunk)
+                if args.slow_kbps:
+                    time.sleep(len(chunk) / (args.slow_kbps * 1024.0))
+
+    def log_message(self, fmt, *a):
+        pass
+
+
+def report():
+    last = 0
+    while True:
+        time.sleep(1)
+        with lock:
+            sent, active, peak = stats["bytes"], stats["active"], stats["peak"]
+        print("连接 %d（峰值 %d），发送 %.0f KB/s，累计 %.1f MB" % (active, peak, (sent - last) / 1024.0,
+                                                             sent / (1024.0 * 1024)), flush=True)
+        last = sent
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("directory")
+    parser.add_argument("--port", type=int, default=8000)
+    parser.add_argument("--fail-rate", type=float, default=0.0)
+    parser.add_argument("--fail-status", type=float, default=0.0)
+    parser.add_argument("--slow-kbps", type=float, default=0.0)
+    args = parser.parse_args()
+
+    threading.Thread(target=report, daemon=True).start()
+    server = ThreadingHTTPServer(("", args.port), lambda *a, **kw: Handler(*a, directory=args.directory, **kw))
+    print("清单地址: http://127.0.0.1:%d%s" % (args.port, MANIFEST), flush=True)
+    server.serve_forever()
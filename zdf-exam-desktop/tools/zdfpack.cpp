@@ -0,0 +1,76 @@
+// zdf-pack：把考试页面的静态资源目录打包为资源包（*.zpack），或列出资源包内容
+//   zdf-pack build --base-url <考试页面资源的基准地址> [-o 输出文件] <资源目录>
+//   zdf-pack list <资源包>
+// 资源目录按服务器上的路径组织，例如基准地址为 http://stu.sdzdf.com/ 时，
+// <资源目录>/static/js/app.js 对应 http://stu.sdzdf.com/static/js/app.js
+#include <QCoreApplication>
+#include <QStringList>
+#include <QFile>
+#include <QDir>
+#include <QDateTime>
+
+#include <cstdio>
+
+#include "../packformat.h"
+#include "../packbuilder.h"
+
+static bool build(const QString &dir, const QString &baseUrl, const QString &outputPath) {
+    zdfpack::BuildResult result;
+    if (!zdfpack::buildPack(dir, baseUrl, outputPath, result)) {
+        fprintf(stderr, "%s\n", qPrintable(result.error));
+        return false;
+    }
+    printf("已打包 %d 个文件，共 %.1f MB：%s\n", result.files, double(result.bytes) / (1024 * 1024), qPrintable(outputPath));
+    return true;
+}
+
+static bool list(const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "无法打开文件: %s\n", qPrintable(path));
+        return false;
+    }
+    const uchar *base = file.map(0, file.size());
+    zdfpack::Reader reader;
+    const char *error = nullptr;
+    if (!base || !reader.open(base, quint64(file.size()), &error)) {
+        fprintf(stderr, "%s: %s\n", qPrintable(path), base ? error : "无法映射文件");
+        return false;
+    }
+    const QByteArray baseUrl = reader.baseUrl();
+    printf("基准地址: %.*s\n", baseUrl.size(), baseUrl.constData());
+    printf("打包时间: %s\n", qPrintable(QDateTime::fromMSecsSinceEpoch(reader.header().createdMs).toString("yyyy-MM-dd hh:mm:ss")));
+    for (int i = 0; i < reader.count(); ++i) {
+        const zdfpack::Reader::Entry e = reader.entryAt(i);
+        // 路径和类型直接引用映射内存，没有结尾的 '\0'
+        printf("%10d  %-28.*s  %.*s\n", e.data.size(), e.mime.size(), e.mime.constData(), e.path.size(), e.path.constData());
+    }
+    printf("共 %d 个文件\n", reader.count());
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    args.removeFirst();
+
+    const QString command = args.value(0);
+    QString baseUrl, outputPath;
+    QStringList inputs;
+    for (int i = 1; i < args.size(); ++i) {
+        const QString &a = args.at(i);
+        if (a == "--base-url" && i + 1 < args.size()) baseUrl = args.at(++i);
+        else if (a == "-o" && i + 1 < args.size()) outputPath = args.at(++i);
+        else inputs << a;
+    }
+
+    if (command == "build" && inputs.size() == 1 && !baseUrl.isEmpty()) {
+        if (outputPath.isEmpty()) outputPath = QDir(inputs.first()).dirName() + zdfpack::PACK_SUFFIX;
+        return build(inputs.first(), baseUrl, outputPath) ? 0 : 1;
+    }
+    if (command == "list" && inputs.size() == 1) return list(inputs.first()) ? 0 : 1;
+
+    fprintf(stderr, "用法: zdf-pack build --base-url <基准地址> [-o 输出文件] <资源目录>\n"
+                    "      zdf-pack list <资源包>\n");
+    return 2;
+}
@@ -0,0 +1,199 @@
+#include "urlfilter.h"
+#include "config.h"
+#include "assetpack.h"
+#include "reqtiming.h"
+
+#include <QMutexLocker>
+#include <QWebEngineProfile>
+#include <QWebEngineUrlRequestInterceptor>
+#include <QWebEngineUrlRequestInfo>
+
+#include <algorithm>
+
+// --------------------------- UrlMatcher ---------------------------
+bool UrlMatcher::addRule(const QString &rule, Verdict verdict) {
+    QString r = rule.trimmed();
+    const int scheme = r.indexOf("://");            // 允许直接写完整网址，协议不参与匹配
+    if (scheme >= 0) r = r.mid(scheme + 3);
+    const int slash = r.indexOf('/');
+    QString host = (slash < 0 ? r : r.left(slash)).toLower();  // 主机名不区分大小写，路径区分
+    const QString path = slash < 0 ? QString() : r.mid(slash);
+    const int colon = host.indexOf(':');
+    if (colon >= 0) host.truncate(colon);
+    const bool wildcard = host.startsWith("*.");
+    if (wildcard) host.remove(0, 2);
+    if (host.isEmpty() || host.contains('*')) return false;
+
+    QHash<QString, int> &hosts = wildcard ? m_wildcardHosts : m_exactHosts;
+    int node = hosts.value(host, -1);
+    if (node < 0) {
+        node = int(m_nodes.size());
+        m_nodes.emplace_back();
+        hosts.insert(host, node);
+    }
+    // 与 lookup 相同的逐段切分（跳过空段），不用已废弃的 QString::SkipEmptyParts
+    for (int pos = 0; pos < path.size(); ) {
+        int next = path.indexOf('/', pos);
+        if (next < 0) next = path.size();
+        if (next > pos) {
+            const QStringRef segment = path.midRef(pos, next - pos);
+            int child = childOf(node, segment);
+            if (child < 0) {
+                child = int(m_nodes.size());
+                m_nodes.emplace_back();
+                std::vector<std::pair<QString, int>> &children = m_nodes[size_t(node)].children;
+                const auto at = std::lower_bound(children.begin(), children.end(), segment,
+                    [](const std::pair<QString, int> &a, const QStringRef &b) { return a.first.compare(b) < 0; });
+                children.insert(at, std::make_pair(segment.toString(), child));
+            }
+            node = child;
+        }
+        pos = next + 1;
+    }
+    Node &target = m_nodes[size_t(node)];
+    if (target.verdict != Deny) target.verdict = verdict;
+    if (verdict == Allow) m_hasAllow = true;
+    ++m_rules;
+    return true;
+}
+
+int UrlMatcher::childOf(int node, const QStringRef &segment) const {
+    const std::vector<std::pair<QString, int>> &children = m_nodes[size_t(node)].children;
+    const auto pos = std::lower_bound(children.begin(), children.end(), segment,
+        [](const std::pair<QString, int> &a, const QStringRef &b) { return a.first.compare(b) < 0; });
+    return pos != children.end() && pos->first.compare(segment) == 0 ? pos->second : -1;
+}
+
+// 沿路径逐段下行，返回经过的最深一个有结论的节点；路径段以 QStringRef 引用，不分配内存
+UrlMatcher::Verdict UrlMatcher::lookup(int root, const QString &path) const {
+    Verdict verdict = m_nodes[size_t(root)].verdict;
+    int node = root;
+    const int length = path.size();
+    for (int pos = 0; pos < length; ) {
+        int next = path.indexOf('/', pos);
+        if (next < 0) next = length;
+        if (next > pos) {
+            node = childOf(node, path.midRef(pos, next - pos));
+            if (node < 0) break;
+            if (m_nodes[size_t(node)].verdict != None) verdict = m_nodes[size_t(node)].verdict;
+        }
+        pos = next + 1;
+    }
+    return verdict;
+}
+
+bool UrlMatcher::allows(const QUrl &url) const {
+    const QString host = url.host();                // QUrl 已转为小写
+    const QString path = url.path();
+    Verdict verdict = None;
+    const auto exact = m_exactHosts.constFind(host);
+    if (exact != m_exactHosts.constEnd()) verdict = lookup(*exact, path);
+    // 通配主机由长到短：a.b.sdzdf.com → b.sdzdf.com → sdzdf.com → com
+    for (int pos = 0; verdict == None && pos >= 0; ) {
+        const auto wildcard = m_wildcardHosts.constFind(pos == 0 ? host : host.mid(pos));
+        if (wildcard != m_wildcardHosts.constEnd()) verdict = lookup(*wildcard, path);
+        pos = host.indexOf('.', pos);
+        if (pos >= 0) ++pos;
+    }
+    if (verdict == None) return !m_hasAllow;
+    return verdict == Allow;
+}
+
+// --------------------------- BlockedRequestStats ---------------------------
+void BlockedRequestStats::record(const QString &host, bool navigation) {
+    QMutexLocker lock(&m_mutex);
+    ++m_pending[host.isEmpty() ? QString("(无主机)") : host];
+    if (navigation) ++m_pendingNavigations;
+}
+
+QString BlockedRequestStats::topHosts(const QHash<QString, int> &counts) {
+    static const int SHOWN = 5;
+    std::vector<std::pair<int, QString>> sorted;
+    sorted.reserve(size_t(counts.size()));
+    for (auto it = counts.constBegin(); it != counts.constEnd(); ++it) sorted.emplace_back(it.value(), it.key());
+    std::sort(sorted.begin(), sorted.end(), [](const std::pair<int, QString> &a, const std::pair<int, QString> &b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+    QStringList parts;
+    for (size_t i = 0; i < sorted.size() && i < size_t(SHOWN); ++i)
+        parts << QString("%1 ×%2").arg(sorted[i].second).arg(sorted[i].first);
+    QString text = parts.join("，");
+    if (sorted.size() > size_t(SHOWN)) text += QString(" 等 %1 个主机").arg(sorted.size());
+    return text;
+}
+
+void BlockedRequestStats::flush() {
+    QHash<QString, int> pending;
+    int navigations;
+    {
+        QMutexLocker lock(&m_mutex);
+        if (m_pending.isEmpty()) return;
+        pending.swap(m_pending);
+        navigations = m_pendingNavigations;
+        m_pendingNavigations = 0;
+        for (auto it = pending.constBegin(); it != pending.constEnd(); ++it) {
+            m_session[it.key()] += it.value();
+            m_sessionTotal += it.value();
+        }
+        m_sessionNavigations += navigations;
+    }
+    int total = 0;
+    for (int n : pending) total += n;
+    ZDF_LOG_EVENT(CatApp, L_WARNING, "网址过滤：拦截 %1 个请求（其中页面跳转 %2 个）：%3",
+                  total, navigations, topHosts(pending));
+}
+
+void BlockedRequestStats::logSession() const {
+    QMutexLocker lock(&m_mutex);
+    if (m_sessionTotal == 0) {
+        ZDF_LOG_EVENT(CatApp, L_INFO, "本次会话网址过滤：未拦截任何请求");
+        return;
+    }
+    ZDF_LOG_EVENT(CatApp, L_INFO, "本次会话网址过滤：共拦截 %1 个请求（其中页面跳转 %2 个）：%3",
+                  m_sessionTotal, m_sessionNavigations, topHosts(m_session));
+}
+
+// --------------------------- 请求拦截器 ---------------------------
+// Qt 5 每个 profile 只能设置一个拦截器，请求计数、网址过滤和资源包改写合在这里。
+// Qt 5.13 起以 setUrlRequestInterceptor 安装，在 GUI 线程调用；更早的版本只有 setRequestInterceptor，
+// 在 WebEngine 的 IO 线程调用，因此这里用到的状态都按可跨线程访问实现。
+// 规则取自当前配置快照（无锁），热更新后的下一个请求即按新规则处理
+class RequestInterceptor : public QWebEngineUrlRequestInterceptor {
+public:
+    explicit RequestInterceptor(QObject *parent) : QWebEngineUrlRequestInterceptor(parent) {}
+
+    void interceptRequest(QWebEngineUrlRequestInfo &info) override {
+        const QUrl url = info.requestUrl();
+        RequestTiming::instance().noteRequest(url);
+        const AppConfig::UrlFilter &filter = ConfigManager::instance().snapshot().urlFilter;
+        if (filter.enabled && filter.matcher && filtered(url.scheme()) && !filter.matcher->allows(url)) {
+            info.block(true);
+            BlockedRequestStats::instance().record(url.host(),
+                info.resourceType() == QWebEngineUrlRequestInfo::ResourceTypeMainFrame);
+            return;
+        }
+        AssetPack::instance().redirect(info);
+    }
+
+private:
+    // data:、blob:、about:、qrc: 和 zdfpack: 是页面内部或本程序提供的内容，不访问网络
+    static bool filtered(const QString &scheme) {
+        return scheme == QLatin1String("http") || scheme == QLatin1String("https") ||
+               scheme == QLatin1String("ws") || scheme == QLatin1String("wss") ||
+               scheme == QLatin1String("ftp") || scheme == QLatin1String("file");
+    }
+};
+
+void installRequestInterceptor(QWebEngineProfile *profile) {
+    const AppConfig &config = ConfigManager::instance().snapshot();
+    if (config.urlFilter.enabled && config.urlFilter.matcher)
+        ZDF_LOG_EVENT(CatStartup, L_INFO, "网址过滤：%1 条规则（允许 %2，禁止 %3）",
+                      config.urlFilter.matcher->ruleCount(), config.urlFilter.allow.size(), config.urlFilter.deny.size());
+    else
+        ZDF_LOG_EVENT(CatStartup, L_INFO, "网址过滤未启用");
+#if QT_VERSION >= QT_VERSION_CHECK(5, 13, 0)
+    profile->setUrlRequestInterceptor(new RequestInterceptor(profile));
+#else
+    profile->setRequestInterceptor(new RequestInterceptor(profile));
+#endif
+}
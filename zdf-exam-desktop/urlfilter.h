@@ -0,0 +1,77 @@
+#ifndef ZDF_URLFILTER_H
+#define ZDF_URLFILTER_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QMutex>
+#include <QUrl>
+
+#include <utility>
+#include <vector>
+
+#include "logger.h"
+
+class QWebEngineProfile;
+
+// --------------------------- 网址规则 ---------------------------
+// config.json 的 urlFilter.allow / deny 在加载时编译为该结构，请求拦截器在每个请求上查询：
+// 主机名先查精确主机的哈希表，再按标签由长到短查通配主机（"*.sdzdf.com" 同时匹配 sdzdf.com），
+// 命中的主机下按路径段前缀树取最长匹配，同一前缀上禁止优先于允许。
+// 没有任何规则命中时：存在允许规则则拦截，否则放行。编译后只读，可在任意线程查询
+class UrlMatcher {
+public:
+    enum Verdict : quint8 { None, Allow, Deny };
+
+    // 规则写法："host"、"*.host"，可带路径前缀 "host/path/"（按整段匹配，/exam 不匹配 /examine）。
+    // 无法解析时返回 false
+    bool addRule(const QString &rule, Verdict verdict);
+
+    bool allows(const QUrl &url) const;
+    int ruleCount() const { return m_rules; }
+
+private:
+    struct Node {
+        std::vector<std::pair<QString, int>> children;     // 按路径段排序，二分查找
+        Verdict verdict = None;
+    };
+
+    int childOf(int node, const QStringRef &segment) const;
+    Verdict lookup(int root, const QString &path) const;
+
+    std::vector<Node> m_nodes;
+    QHash<QString, int> m_exactHosts;       // 主机名 → 前缀树根节点
+    QHash<QString, int> m_wildcardHosts;    // 去掉 "*." 的主机后缀 → 前缀树根节点
+    bool m_hasAllow = false;
+    int m_rules = 0;
+};
+
+// --------------------------- 拦截统计 ---------------------------
+// 被拦截的请求按主机汇总，不逐条写日志；由维护定时器定期写出本周期的汇总。
+// record 由请求拦截器调用（Qt 5.13 起在 GUI 线程，更早的版本在 WebEngine 的 IO 线程，故加锁），其余在 GUI 线程
+class BlockedRequestStats {
+public:
+    static BlockedRequestStats& instance(){ static BlockedRequestStats s; return s; }
+
+    void record(const QString &host, bool navigation);
+
+    // 写出上次以来的拦截汇总（没有新拦截时不写），并计入会话累计
+    void flush();
+    void logSession() const;
+
+private:
+    BlockedRequestStats() = default;
+    BlockedRequestStats(const BlockedRequestStats&)=delete; BlockedRequestStats& operator=(const BlockedRequestStats&)=delete;
+
+    static QString topHosts(const QHash<QString, int> &counts);
+
+    mutable QMutex m_mutex;
+    QHash<QString, int> m_pending, m_session;
+    int m_pendingNavigations{0}, m_sessionTotal{0}, m_sessionNavigations{0};
+};
+
+// 在 profile 上安装唯一的请求拦截器：计入请求计时，按当前配置快照的网址规则拦截，再交给本地资源包改写。
+// 规则随配置热更新生效。须在首个页面创建前调用
+void installRequestInterceptor(QWebEngineProfile *profile);
+
+#endif // ZDF_URLFILTER_H